@@ -23,7 +23,9 @@ EBGodunov::ExtrapVelToFaces ( MultiFab const& vel,
                               Vector<BCRec> const& h_bcrec,
                               BCRec  const* d_bcrec,
                               const Geometry& geom,
-                              Real l_dt,  MultiFab const* velocity_on_eb_inflow)
+                              Real l_dt,  MultiFab const* velocity_on_eb_inflow,
+                              HydroUtils::AdvectiveCFLReducer* cfl,
+                              HydroUtils::TileRegion region)
 {
     BL_PROFILE("EBGodunov::ExtrapVelToFaces()");
     AMREX_ALWAYS_ASSERT(vel.hasEBFabFactory());
@@ -39,194 +41,224 @@ EBGodunov::ExtrapVelToFaces ( MultiFab const& vel,
     auto const& areafrac = ebfact.getAreaFrac();
 
     // Since we don't fill all the ghost cells in the mac vel arrays
-    // we need to initialize to something which won't make the code crash
-    AMREX_D_TERM( u_mac.setVal(covered_val);,
-                  v_mac.setVal(covered_val);,
-                  w_mac.setVal(covered_val););
+    // we need to initialize to something which won't make the code crash.
+    // The Halo pass must keep what the Interior pass computed.
+    if (region != HydroUtils::TileRegion::Halo) {
+        AMREX_D_TERM( u_mac.setVal(covered_val);,
+                      v_mac.setVal(covered_val);,
+                      w_mac.setVal(covered_val););
+    }
+
+    // Cells read beyond a box when computing the velocities on its faces
+    const int nghost = HydroUtils::nGrowRequired("Godunov", true, "", HydroUtils::GhostField::State);
 
     const int ncomp = AMREX_SPACEDIM;
+
+    HydroUtils::TileScheduler sched(vel, nghost);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     {
         FArrayBox scratch;
-        for (MFIter mfi(vel,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        for (int pass = 0; pass < sched.numPasses(); ++pass)
         {
-            Box const& bx = mfi.tilebox();
-
-            EBCellFlagFab const& flagfab = flags[mfi];
-            Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
-
-            AMREX_D_TERM( Array4<Real> const& a_umac = u_mac.array(mfi);,
-                          Array4<Real> const& a_vmac = v_mac.array(mfi);,
-                          Array4<Real> const& a_wmac = w_mac.array(mfi););
-
-            Array4<Real const> const& a_vel = vel.const_array(mfi);
-            Array4<Real const> const& a_f = vel_forces.const_array(mfi);
-
-            // In 2-d:
-            //  8*ncomp are:  Imx, Ipx, Imy, Ipy, xlo/xhi, ylo/yhi
-            //  2       are:  u_ad, v_ad
-            // In 3-d:
-            // 12*ncomp are:  Imx, Ipx, Imy, Ipy, Imz, Ipz, xlo/xhi, ylo/yhi, zlo/zhi
-            //  3       are:  u_ad, v_ad, w_ad
-            //
-            // This over-allots for EB regular boxes, which need grow(bx,1)
-            // vs. grow(bx,2) here. EB needs the 2nd ghost cell for creating
-            // the transverse terms.
-            Box const& bxg2 = amrex::grow(bx,2);
-            scratch.resize(bxg2, (4*ncomp + 1)*AMREX_SPACEDIM);
-            Real* p  = scratch.dataPtr();
-
-            AMREX_D_TERM(Box const& xbx = mfi.nodaltilebox(0);,
-                         Box const& ybx = mfi.nodaltilebox(1);,
-                         Box const& zbx = mfi.nodaltilebox(2));;
+            for (MFIter mfi(vel, sched.info()); mfi.isValid(); ++mfi)
+            {
+                if (!sched.inPass(mfi, pass)) { continue; }
+                HydroUtils::TileScheduler::BusyTimer busy_timer(sched);
+
+                EBCellFlagFab const& flagfab = flags[mfi];
+                Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
+
+                AMREX_D_TERM( Array4<Real> const& a_umac = u_mac.array(mfi);,
+                              Array4<Real> const& a_vmac = v_mac.array(mfi);,
+                              Array4<Real> const& a_wmac = w_mac.array(mfi););
+
+                Array4<Real const> const& a_vel = vel.const_array(mfi);
+                Array4<Real const> const& a_f = vel_forces.const_array(mfi);
+
+                // The scheme is picked box by box below, so only split tiles where
+                // the regular one is picked for the whole tile
+                const bool split = (flagfab.getType(amrex::grow(mfi.tilebox(),3)) == FabType::regular);
+
+                for (Box const& bx : HydroUtils::TileRegionBoxes(mfi, region, nghost, split))
+                {
+                    // In 2-d:
+                    //  8*ncomp are:  Imx, Ipx, Imy, Ipy, xlo/xhi, ylo/yhi
+                    //  2       are:  u_ad, v_ad
+                    // In 3-d:
+                    // 12*ncomp are:  Imx, Ipx, Imy, Ipy, Imz, Ipz, xlo/xhi, ylo/yhi, zlo/zhi
+                    //  3       are:  u_ad, v_ad, w_ad
+                    //
+                    // This over-allots for EB regular boxes, which need grow(bx,1)
+                    // vs. grow(bx,2) here. EB needs the 2nd ghost cell for creating
+                    // the transverse terms.
+                    Box const& bxg2 = amrex::grow(bx,2);
+                    scratch.resize(bxg2, (4*ncomp + 1)*AMREX_SPACEDIM);
+                    Real* p  = scratch.dataPtr();
+
+                    AMREX_D_TERM(Box const& xbx = amrex::surroundingNodes(bx,0) & mfi.nodaltilebox(0);,
+                                 Box const& ybx = amrex::surroundingNodes(bx,1) & mfi.nodaltilebox(1);,
+                                 Box const& zbx = amrex::surroundingNodes(bx,2) & mfi.nodaltilebox(2););
 
 #if (AMREX_SPACEDIM == 2)
-            Box xebx_g2(Box(bx).grow(1).grow(1,1).surroundingNodes(0));
-            Box yebx_g2(Box(bx).grow(1).grow(0,1).surroundingNodes(1));
+                    Box xebx_g2(Box(bx).grow(1).grow(1,1).surroundingNodes(0));
+                    Box yebx_g2(Box(bx).grow(1).grow(0,1).surroundingNodes(1));
 #else
-            Box xebx_g2(Box(bx).grow(1).grow(1,1).grow(2,1).surroundingNodes(0));
-            Box yebx_g2(Box(bx).grow(1).grow(0,1).grow(2,1).surroundingNodes(1));
-            Box zebx_g2(Box(bx).grow(1).grow(0,1).grow(1,1).surroundingNodes(2));
+                    Box xebx_g2(Box(bx).grow(1).grow(1,1).grow(2,1).surroundingNodes(0));
+                    Box yebx_g2(Box(bx).grow(1).grow(0,1).grow(2,1).surroundingNodes(1));
+                    Box zebx_g2(Box(bx).grow(1).grow(0,1).grow(1,1).surroundingNodes(2));
 #endif
 
-            Array4<Real> Imx = makeArray4(p,bxg2,ncomp);
-            p +=         Imx.size();
-            Array4<Real> Ipx = makeArray4(p,bxg2,ncomp);
-            p +=         Ipx.size();
-            Array4<Real> Imy = makeArray4(p,bxg2,ncomp);
-            p +=         Imy.size();
-            Array4<Real> Ipy = makeArray4(p,bxg2,ncomp);
-            p +=         Ipy.size();
+                    Array4<Real> Imx = makeArray4(p,bxg2,ncomp);
+                    p +=         Imx.size();
+                    Array4<Real> Ipx = makeArray4(p,bxg2,ncomp);
+                    p +=         Ipx.size();
+                    Array4<Real> Imy = makeArray4(p,bxg2,ncomp);
+                    p +=         Imy.size();
+                    Array4<Real> Ipy = makeArray4(p,bxg2,ncomp);
+                    p +=         Ipy.size();
 
-            Array4<Real> u_ad = makeArray4(p,xebx_g2,1);
-            p +=         u_ad.size();
-            Array4<Real> v_ad = makeArray4(p,yebx_g2,1);
-            p +=         v_ad.size();
+                    Array4<Real> u_ad = makeArray4(p,xebx_g2,1);
+                    p +=         u_ad.size();
+                    Array4<Real> v_ad = makeArray4(p,yebx_g2,1);
+                    p +=         v_ad.size();
 
 #if (AMREX_SPACEDIM == 3)
-            Array4<Real> Imz = makeArray4(p,bxg2,ncomp);
-            p +=         Imz.size();
-            Array4<Real> Ipz = makeArray4(p,bxg2,ncomp);
-            p +=         Ipz.size();
+                    Array4<Real> Imz = makeArray4(p,bxg2,ncomp);
+                    p +=         Imz.size();
+                    Array4<Real> Ipz = makeArray4(p,bxg2,ncomp);
+                    p +=         Ipz.size();
 
-            Array4<Real> w_ad = makeArray4(p,zebx_g2,1);
-            p +=         w_ad.size();
+                    Array4<Real> w_ad = makeArray4(p,zebx_g2,1);
+                    p +=         w_ad.size();
 #endif
 
-            // This tests on covered cells just in the box itself
-            if (flagfab.getType(bx) == FabType::covered)
-            {
-                // We shouldn't need to zero these
+                    // This tests on covered cells just in the box itself
+                    if (flagfab.getType(bx) == FabType::covered)
+                    {
+                        // We shouldn't need to zero these
 
-            }
-            // Test includes 3 rows of ghost cells.
-            // Godunov::ExtrapVelToFacesOnBox is callled on bx => need u_ad on
-            // xebx_g1 (not xebx_g2 as in EB). Then need PredictVelOnXFace on
-            // xebx_g1, which will call slopes on cell (i-1), slopes uses cell (i-1)-2
-            // => check regular on grow 3
-            else if (flagfab.getType(amrex::grow(bx,3)) == FabType::regular)
-            {
+                    }
+                    // Test includes 3 rows of ghost cells.
+                    // Godunov::ExtrapVelToFacesOnBox is callled on bx => need u_ad on
+                    // xebx_g1 (not xebx_g2 as in EB). Then need PredictVelOnXFace on
+                    // xebx_g1, which will call slopes on cell (i-1), slopes uses cell (i-1)-2
+                    // => check regular on grow 3
+                    else if (flagfab.getType(amrex::grow(bx,3)) == FabType::regular)
+                    {
 
 #if (AMREX_SPACEDIM == 2)
-                Box xebx_g1(Box(bx).grow(1,1).surroundingNodes(0));
-                Box yebx_g1(Box(bx).grow(0,1).surroundingNodes(1));
+                        Box xebx_g1(Box(bx).grow(1,1).surroundingNodes(0));
+                        Box yebx_g1(Box(bx).grow(0,1).surroundingNodes(1));
 #else
-                Box xebx_g1(Box(bx).grow(1,1).grow(2,1).surroundingNodes(0));
-                Box yebx_g1(Box(bx).grow(0,1).grow(2,1).surroundingNodes(1));
-                Box zebx_g1(Box(bx).grow(0,1).grow(1,1).surroundingNodes(2));
+                        Box xebx_g1(Box(bx).grow(1,1).grow(2,1).surroundingNodes(0));
+                        Box yebx_g1(Box(bx).grow(0,1).grow(2,1).surroundingNodes(1));
+                        Box zebx_g1(Box(bx).grow(0,1).grow(1,1).surroundingNodes(2));
 #endif
 
-                PLM::PredictVelOnXFace( xebx_g1, AMREX_SPACEDIM, Imx, Ipx, a_vel, a_vel,
-                                        geom, l_dt, h_bcrec, d_bcrec);
+                        PLM::PredictVelOnXFace( xebx_g1, AMREX_SPACEDIM, Imx, Ipx, a_vel, a_vel,
+                                                geom, l_dt, h_bcrec, d_bcrec);
 
-                PLM::PredictVelOnYFace( yebx_g1, AMREX_SPACEDIM, Imy, Ipy, a_vel, a_vel,
-                                        geom, l_dt, h_bcrec, d_bcrec);
+                        PLM::PredictVelOnYFace( yebx_g1, AMREX_SPACEDIM, Imy, Ipy, a_vel, a_vel,
+                                                geom, l_dt, h_bcrec, d_bcrec);
 
 #if ( AMREX_SPACEDIM == 3 )
-                PLM::PredictVelOnZFace( zebx_g1, AMREX_SPACEDIM, Imz, Ipz, a_vel, a_vel,
-                                        geom, l_dt, h_bcrec, d_bcrec);
+                        PLM::PredictVelOnZFace( zebx_g1, AMREX_SPACEDIM, Imz, Ipz, a_vel, a_vel,
+                                                geom, l_dt, h_bcrec, d_bcrec);
 #endif
 
 
-                bool local_use_forces_in_trans = false;
-                Godunov::ComputeAdvectiveVel( AMREX_D_DECL(xebx_g1, yebx_g1, zebx_g1),
-                                              AMREX_D_DECL(u_ad, v_ad, w_ad),
-                                              AMREX_D_DECL(Imx, Imy, Imz),
-                                              AMREX_D_DECL(Ipx, Ipy, Ipz),
-                                              a_vel, a_f, domain, l_dt, d_bcrec,
-                                              local_use_forces_in_trans);
-
-                Godunov::ExtrapVelToFacesOnBox( bx, ncomp,
-                                                AMREX_D_DECL(xbx, ybx, zbx),
-                                                AMREX_D_DECL(a_umac, a_vmac, a_wmac),
-                                                a_vel,
-                                                AMREX_D_DECL(u_ad, v_ad, w_ad),
-                                                AMREX_D_DECL(Imx, Imy, Imz),
-                                                AMREX_D_DECL(Ipx, Ipy, Ipz),
-                                                a_f, domain, dx, l_dt, d_bcrec,
-                                                local_use_forces_in_trans, p);
-            }
-            else
-            {
-
-                AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                             Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                             Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
-
-                Array4<Real const> const& ccent_arr = ccent.const_array(mfi);
-                Array4<Real const> const& vfrac_arr = vfrac.const_array(mfi);
-
-                EBPLM::PredictVelOnXFace( xebx_g2, Imx, Ipx, a_vel, a_vel,
-                                          flagarr, vfrac_arr,
-                                          AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
-                                          geom, l_dt, h_bcrec, d_bcrec );
-
-                EBPLM::PredictVelOnYFace( yebx_g2, Imy, Ipy, a_vel, a_vel,
-                                          flagarr, vfrac_arr,
-                                          AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
-                                          geom, l_dt, h_bcrec, d_bcrec );
+                        bool local_use_forces_in_trans = false;
+                        Godunov::ComputeAdvectiveVel( AMREX_D_DECL(xebx_g1, yebx_g1, zebx_g1),
+                                                      AMREX_D_DECL(u_ad, v_ad, w_ad),
+                                                      AMREX_D_DECL(Imx, Imy, Imz),
+                                                      AMREX_D_DECL(Ipx, Ipy, Ipz),
+                                                      a_vel, a_f, domain, l_dt, d_bcrec,
+                                                      local_use_forces_in_trans);
+
+                        Godunov::ExtrapVelToFacesOnBox( bx, ncomp,
+                                                        AMREX_D_DECL(xbx, ybx, zbx),
+                                                        AMREX_D_DECL(a_umac, a_vmac, a_wmac),
+                                                        a_vel,
+                                                        AMREX_D_DECL(u_ad, v_ad, w_ad),
+                                                        AMREX_D_DECL(Imx, Imy, Imz),
+                                                        AMREX_D_DECL(Ipx, Ipy, Ipz),
+                                                        a_f, domain, dx, l_dt, d_bcrec,
+                                                        local_use_forces_in_trans, p);
+                    }
+                    else
+                    {
+
+                        AMREX_D_TERM(Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
+                                     Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
+                                     Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
+
+                        Array4<Real const> const& ccent_arr = ccent.const_array(mfi);
+                        Array4<Real const> const& vfrac_arr = vfrac.const_array(mfi);
+
+                        EBPLM::PredictVelOnXFace( xebx_g2, Imx, Ipx, a_vel, a_vel,
+                                                  flagarr, vfrac_arr,
+                                                  AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
+                                                  geom, l_dt, h_bcrec, d_bcrec );
+
+                        EBPLM::PredictVelOnYFace( yebx_g2, Imy, Ipy, a_vel, a_vel,
+                                                  flagarr, vfrac_arr,
+                                                  AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
+                                                  geom, l_dt, h_bcrec, d_bcrec );
 
 #if (AMREX_SPACEDIM == 3)
-                EBPLM::PredictVelOnZFace( zebx_g2, Imz, Ipz, a_vel, a_vel,
-                                          flagarr, vfrac_arr,
-                                          AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
-                                          geom, l_dt, h_bcrec, d_bcrec );
+                        EBPLM::PredictVelOnZFace( zebx_g2, Imz, Ipz, a_vel, a_vel,
+                                                  flagarr, vfrac_arr,
+                                                  AMREX_D_DECL(fcx,fcy,fcz),ccent_arr,
+                                                  geom, l_dt, h_bcrec, d_bcrec );
 #endif
 
-                EBGodunov::ComputeAdvectiveVel( AMREX_D_DECL(xebx_g2, yebx_g2, zebx_g2),
-                                                AMREX_D_DECL(u_ad, v_ad, w_ad),
-                                                AMREX_D_DECL(Imx, Imy, Imz),
-                                                AMREX_D_DECL(Ipx, Ipy, Ipz),
-                                                a_vel, flagarr, domain, d_bcrec);
-
-                AMREX_D_TERM(Array4<Real const> const& apx = areafrac[0]->const_array(mfi);,
-                             Array4<Real const> const& apy = areafrac[1]->const_array(mfi);,
-                             Array4<Real const> const& apz = areafrac[2]->const_array(mfi););
-
-                EBGodunov::ExtrapVelToFacesOnBox( bx, ncomp,
-                                                  AMREX_D_DECL(xbx,ybx,zbx),
-                                                  AMREX_D_DECL(xebx_g2,yebx_g2,zebx_g2),
-                                                  AMREX_D_DECL(a_umac, a_vmac, a_wmac),
-                                                  a_vel,
-                                                  AMREX_D_DECL(u_ad, v_ad, w_ad),
-                                                  AMREX_D_DECL(Imx, Imy, Imz),
-                                                  AMREX_D_DECL(Ipx, Ipy, Ipz),
-                                                  a_f,
-                                                  domain, dx, l_dt, d_bcrec,
-                                                  flagarr,
-                                                  AMREX_D_DECL(apx, apy, apz),
+                        EBGodunov::ComputeAdvectiveVel( AMREX_D_DECL(xebx_g2, yebx_g2, zebx_g2),
+                                                        AMREX_D_DECL(u_ad, v_ad, w_ad),
+                                                        AMREX_D_DECL(Imx, Imy, Imz),
+                                                        AMREX_D_DECL(Ipx, Ipy, Ipz),
+                                                        a_vel, flagarr, domain, d_bcrec);
+
+                        AMREX_D_TERM(Array4<Real const> const& apx = areafrac[0]->const_array(mfi);,
+                                     Array4<Real const> const& apy = areafrac[1]->const_array(mfi);,
+                                     Array4<Real const> const& apz = areafrac[2]->const_array(mfi););
+
+                        EBGodunov::ExtrapVelToFacesOnBox( bx, ncomp,
+                                                          AMREX_D_DECL(xbx,ybx,zbx),
+                                                          AMREX_D_DECL(xebx_g2,yebx_g2,zebx_g2),
+                                                          AMREX_D_DECL(a_umac, a_vmac, a_wmac),
+                                                          a_vel,
+                                                          AMREX_D_DECL(u_ad, v_ad, w_ad),
+                                                          AMREX_D_DECL(Imx, Imy, Imz),
+                                                          AMREX_D_DECL(Ipx, Ipy, Ipz),
+                                                          a_f,
+                                                          domain, dx, l_dt, d_bcrec,
+                                                          flagarr,
+                                                          AMREX_D_DECL(apx, apy, apz),
 #if (AMREX_SPACEDIM == 3)
-                                                  vfrac_arr,
+                                                          vfrac_arr,
 #endif
-                                                  AMREX_D_DECL(fcx, fcy, fcz),
-                                                  p,
-                                                  velocity_on_eb_inflow ?
-                                                     velocity_on_eb_inflow->const_array(mfi) : Array4<Real const>{});
+                                                          AMREX_D_DECL(fcx, fcy, fcz),
+                                                          p,
+                                                          velocity_on_eb_inflow ?
+                                                             velocity_on_eb_inflow->const_array(mfi) : Array4<Real const>{});
+                    }
+
+                    Gpu::streamSynchronize();  // otherwise we might be using too much memory
+                }
+
+                if (cfl && region != HydroUtils::TileRegion::Interior &&
+                    flagfab.getType(mfi.tilebox()) != FabType::covered)
+                {
+                    cfl->add(mfi.tilebox(), a_vel,
+                             AMREX_D_DECL(mfi.nodaltilebox(0),
+                                          mfi.nodaltilebox(1),
+                                          mfi.nodaltilebox(2)),
+                             AMREX_D_DECL(a_umac,a_vmac,a_wmac), flagarr);
+                }
             }
-
-            Gpu::streamSynchronize();  // otherwise we might be using too much memory
         }
     }
 }
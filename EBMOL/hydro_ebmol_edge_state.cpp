@@ -7,6 +7,7 @@
 
 #include <hydro_ebmol.H>
 #include <hydro_ebmol_edge_state_K.H>
+#include <hydro_utils.H>
 
 using namespace amrex;
 
@@ -85,102 +86,112 @@ EBMOL::ComputeEdgeState ( Box const& bx,
 #endif
 
 
-    if ((has_extdir_or_ho_lo_x && domain_ilo >= ubx.smallEnd(0)-1) ||
+    // ****************************************************************************
+    // Only the faces whose stencil reaches the first or last layer of cells of
+    //     the domain need the ext_dir/hoextrap aware kernels. If the box touches
+    //     such a boundary, split off those boundary slabs and use the plain
+    //     kernels on the rest of the box.
+    // ****************************************************************************
+
+    const bool has_extdir_or_ho_slab =
+        (has_extdir_or_ho_lo_x && domain_ilo >= ubx.smallEnd(0)-1) ||
         (has_extdir_or_ho_hi_x && domain_ihi <= ubx.bigEnd(0)    ) ||
         (has_extdir_or_ho_lo_y && domain_jlo >= vbx.smallEnd(1)-1) ||
         (has_extdir_or_ho_hi_y && domain_jhi <= vbx.bigEnd(1)    )
-#if (AMREX_SPACEDIM == 2)
-        )
-#elif (AMREX_SPACEDIM == 3)
+#if (AMREX_SPACEDIM == 3)
         ||
         (has_extdir_or_ho_lo_z && domain_klo >= wbx.smallEnd(2)-1) ||
-        (has_extdir_or_ho_hi_z && domain_khi <= wbx.bigEnd(2)    ) )
+        (has_extdir_or_ho_hi_z && domain_khi <= wbx.bigEnd(2)    )
 #endif
-    {
+        ;
 
-        // ****************************************************************************
-        // Predict to x-faces
-        // ****************************************************************************
-        amrex::ParallelFor(ubx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
-                                        flag,umac, xedge, domain, vfrac, order, is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-        {
-           if (flag(i,j,k).isConnected(-1,0,0))
-           {
-               xedge(i,j,k,n) = EBMOL::hydro_ebmol_xedge_state_extdir( AMREX_D_DECL(i, j, k), n, q, umac,
-                                                                       AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
-                                                                       flag, d_bcrec_ptr, domain, order, is_velocity );
-           }
-           else
-           {
-               xedge(i,j,k,n) = 0.0;
-           }
-        });
+    const Array<bool,AMREX_SPACEDIM> bc_lo{AMREX_D_DECL(has_extdir_or_ho_lo_x,
+                                                        has_extdir_or_ho_lo_y,
+                                                        has_extdir_or_ho_lo_z)};
+    const Array<bool,AMREX_SPACEDIM> bc_hi{AMREX_D_DECL(has_extdir_or_ho_hi_x,
+                                                        has_extdir_or_ho_hi_y,
+                                                        has_extdir_or_ho_hi_z)};
+    Vector<Box> slabs;
 
-        // ****************************************************************************
-        // Predict to y-faces
-        // ****************************************************************************
-        amrex::ParallelFor(vbx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
-                                        flag,vmac,yedge,domain,vfrac,order, is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+    // ****************************************************************************
+    // Predict to x-faces
+    // ****************************************************************************
+    Box ubx_interior = ubx;
+    if (has_extdir_or_ho_slab)
+    {
+        ubx_interior = HydroUtils::SplitBoundarySlabs(ubx, domain, bc_lo, bc_hi, slabs);
+
+        for (Box const& sbx : slabs)
         {
-            if (flag(i,j,k).isConnected(0,-1,0))
-            {
-                yedge(i,j,k,n) = EBMOL::hydro_ebmol_yedge_state_extdir( AMREX_D_DECL(i, j, k), n, q, vmac,
-                                        AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
-                                                                        flag, d_bcrec_ptr, domain, order, is_velocity );
-            }
-            else
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                            flag,umac,xedge,domain,vfrac,order,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
             {
-                yedge(i,j,k,n) = 0.0;
-            }
-        });
+                if (flag(i,j,k).isConnected(-1,0,0))
+                {
+                    xedge(i,j,k,n) = EBMOL::hydro_ebmol_xedge_state_extdir( AMREX_D_DECL(i, j, k), n, q, umac,
+                                                                            AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
+                                                                            flag, d_bcrec_ptr, domain, order, is_velocity );
+                }
+                else
+                {
+                    xedge(i,j,k,n) = 0.0;
+                }
+            });
+        }
+    }
 
-#if ( AMREX_SPACEDIM == 3 )
-        // ****************************************************************************
-        // Predict to z-faces
-        // ****************************************************************************
-        amrex::ParallelFor(wbx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
-                                        flag,wmac,zedge,domain,vfrac,order, is_velocity]
+    if (ubx_interior.ok())
+    {
+        amrex::ParallelFor(ubx_interior, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                               flag,umac,xedge,domain,vfrac,order,is_velocity]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
-            if (flag(i,j,k).isConnected(0,0,-1))
+            if (flag(i,j,k).isConnected(-1,0,0))
             {
-                zedge(i,j,k,n) = EBMOL::hydro_ebmol_zedge_state_extdir( i, j, k, n, q, wmac,
-                                        AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
-                                                                        flag, d_bcrec_ptr, domain, order, is_velocity );
+                xedge(i,j,k,n) = EBMOL::hydro_ebmol_xedge_state( AMREX_D_DECL(i, j, k), n, q, umac,
+                                                                 AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
+                                                                 flag, d_bcrec_ptr, domain, order, is_velocity );
             }
             else
             {
-                zedge(i,j,k,n) = 0.0;
+                xedge(i,j,k,n) = 0.0;
             }
         });
-#endif
     }
-    else // We assume below that the stencil does not need to use hoextrap or extdir boundaries
+
+    // ****************************************************************************
+    // Predict to y-faces
+    // ****************************************************************************
+    Box vbx_interior = vbx;
+    if (has_extdir_or_ho_slab)
     {
-        // ****************************************************************************
-        // Predict to x-faces
-        // ****************************************************************************
-        amrex::ParallelFor(ubx, ncomp, [d_bcrec_ptr, q,ccc,AMREX_D_DECL(fcx,fcy,fcz),flag, umac, xedge, vfrac, domain, order, is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        vbx_interior = HydroUtils::SplitBoundarySlabs(vbx, domain, bc_lo, bc_hi, slabs);
+
+        for (Box const& sbx : slabs)
         {
-           if (flag(i,j,k).isConnected(-1,0,0))
-           {
-                xedge(i,j,k,n) = EBMOL::hydro_ebmol_xedge_state( AMREX_D_DECL(i, j, k), n, q, umac,
-                                                                 AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
-                                                                 flag, d_bcrec_ptr, domain, order, is_velocity );
-           }
-           else
-           {
-                xedge(i,j,k,n) = 0.0;
-           }
-        });
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                            flag,vmac,yedge,domain,vfrac,order,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (flag(i,j,k).isConnected(0,-1,0))
+                {
+                    yedge(i,j,k,n) = EBMOL::hydro_ebmol_yedge_state_extdir( AMREX_D_DECL(i, j, k), n, q, vmac,
+                                                                            AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
+                                                                            flag, d_bcrec_ptr, domain, order, is_velocity );
+                }
+                else
+                {
+                    yedge(i,j,k,n) = 0.0;
+                }
+            });
+        }
+    }
 
-        // ****************************************************************************
-        // Predict to y-faces
-        // ****************************************************************************
-        amrex::ParallelFor(vbx, ncomp, [d_bcrec_ptr, q,ccc,AMREX_D_DECL(fcx,fcy,fcz),flag, vmac, yedge, vfrac, domain, order, is_velocity]
+    if (vbx_interior.ok())
+    {
+        amrex::ParallelFor(vbx_interior, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                               flag,vmac,yedge,domain,vfrac,order,is_velocity]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             if (flag(i,j,k).isConnected(0,-1,0))
@@ -194,17 +205,46 @@ EBMOL::ComputeEdgeState ( Box const& bx,
                 yedge(i,j,k,n) = 0.0;
             }
         });
+    }
 
 #if ( AMREX_SPACEDIM == 3 )
-        // ****************************************************************************
-        // Predict to z-faces
-        // ****************************************************************************
-        amrex::ParallelFor(wbx, ncomp, [d_bcrec_ptr, q,ccc,AMREX_D_DECL(fcx,fcy,fcz),flag, wmac, zedge, vfrac, domain, order, is_velocity]
+    // ****************************************************************************
+    // Predict to z-faces
+    // ****************************************************************************
+    Box wbx_interior = wbx;
+    if (has_extdir_or_ho_slab)
+    {
+        wbx_interior = HydroUtils::SplitBoundarySlabs(wbx, domain, bc_lo, bc_hi, slabs);
+
+        for (Box const& sbx : slabs)
+        {
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                            flag,wmac,zedge,domain,vfrac,order,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                if (flag(i,j,k).isConnected(0,0,-1))
+                {
+                    zedge(i,j,k,n) = EBMOL::hydro_ebmol_zedge_state_extdir( i, j, k, n, q, wmac,
+                                                                            AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
+                                                                            flag, d_bcrec_ptr, domain, order, is_velocity );
+                }
+                else
+                {
+                    zedge(i,j,k,n) = 0.0;
+                }
+            });
+        }
+    }
+
+    if (wbx_interior.ok())
+    {
+        amrex::ParallelFor(wbx_interior, ncomp, [d_bcrec_ptr,q,ccc,AMREX_D_DECL(fcx,fcy,fcz),
+                                               flag,wmac,zedge,domain,vfrac,order,is_velocity]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             if (flag(i,j,k).isConnected(0,0,-1))
             {
-                zedge(i,j,k,n) = EBMOL::hydro_ebmol_zedge_state( AMREX_D_DECL(i, j, k), n, q, wmac,
+                zedge(i,j,k,n) = EBMOL::hydro_ebmol_zedge_state( i, j, k, n, q, wmac,
                                                                  AMREX_D_DECL(fcx,fcy,fcz), ccc, vfrac,
                                                                  flag, d_bcrec_ptr, domain, order, is_velocity );
             }
@@ -213,8 +253,7 @@ EBMOL::ComputeEdgeState ( Box const& bx,
                 zedge(i,j,k,n) = 0.0;
             }
         });
-#endif
     }
-
+#endif
 }
 /** @} */
@@ -24,7 +24,9 @@ EBMOL::ExtrapVelToFaces ( const MultiFab&  a_vel,
                                         MultiFab& a_wmac ),
                           const Geometry&  a_geom,
                           const Vector<BCRec>& h_bcrec,
-                          BCRec  const* d_bcrec)
+                          BCRec  const* d_bcrec,
+                          HydroUtils::AdvectiveCFLReducer* cfl,
+                          HydroUtils::TileRegion region)
 {
     BL_PROFILE("EBMOL::ExtrapVelToFaces");
 
@@ -36,58 +38,97 @@ EBMOL::ExtrapVelToFaces ( const MultiFab&  a_vel,
     auto const& ccent = fact.getCentroid();
 #endif
 
+    // Cells read beyond a box when computing the velocities on its faces
+    const int nghost = HydroUtils::nGrowRequired("MOL", true, "", HydroUtils::GhostField::State);
+
+    HydroUtils::TileScheduler sched(a_vel, nghost);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     {
-        for (MFIter mfi(a_vel, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        for (int pass = 0; pass < sched.numPasses(); ++pass)
         {
-            AMREX_D_TERM( Box const& ubx = mfi.nodaltilebox(0);,
-                          Box const& vbx = mfi.nodaltilebox(1);,
-                          Box const& wbx = mfi.nodaltilebox(2););
+            for (MFIter mfi(a_vel, sched.info()); mfi.isValid(); ++mfi)
+            {
+                if (!sched.inPass(mfi, pass)) { continue; }
+                HydroUtils::TileScheduler::BusyTimer busy_timer(sched);
 
-            AMREX_D_TERM( Array4<Real> const& u = a_umac.array(mfi);,
-                          Array4<Real> const& v = a_vmac.array(mfi);,
-                          Array4<Real> const& w = a_wmac.array(mfi););
+                AMREX_D_TERM( Array4<Real> const& u = a_umac.array(mfi);,
+                              Array4<Real> const& v = a_vmac.array(mfi);,
+                              Array4<Real> const& w = a_wmac.array(mfi););
 
-            Array4<Real const> const& vcc = a_vel.const_array(mfi);
+                Array4<Real const> const& vcc = a_vel.const_array(mfi);
 
 #ifdef AMREX_USE_EB
-            Box const& bx = mfi.tilebox();
-            EBCellFlagFab const& flagfab = flags[mfi];
-            Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
-            auto const typ = flagfab.getType(amrex::grow(bx,2));
-            if (typ == FabType::covered)
-            {
-                amrex::ParallelFor(ubx, [u]
-                AMREX_GPU_DEVICE (int i, int j, int k) noexcept { u(i,j,k) = 0.0; });
-                amrex::ParallelFor(vbx, [v]
-                AMREX_GPU_DEVICE (int i, int j, int k) noexcept { v(i,j,k) = 0.0; });
+                EBCellFlagFab const& flagfab = flags[mfi];
+                Array4<EBCellFlag const> const& flagarr = flagfab.const_array();
+
+                // The scheme is picked box by box below, so only split tiles where
+                // the regular one is picked for the whole tile
+                const bool split = (flagfab.getType(amrex::grow(mfi.tilebox(),2)) == FabType::regular);
+#else
+                const bool split = true;
+#endif
+
+                for (Box const& bx : HydroUtils::TileRegionBoxes(mfi, region, nghost, split))
+                {
+                    AMREX_D_TERM( Box const& ubx = amrex::surroundingNodes(bx,0) & mfi.nodaltilebox(0);,
+                                  Box const& vbx = amrex::surroundingNodes(bx,1) & mfi.nodaltilebox(1);,
+                                  Box const& wbx = amrex::surroundingNodes(bx,2) & mfi.nodaltilebox(2););
+
+#ifdef AMREX_USE_EB
+                    auto const typ = flagfab.getType(amrex::grow(bx,2));
+                    if (typ == FabType::covered)
+                    {
+                        amrex::ParallelFor(ubx, [u]
+                        AMREX_GPU_DEVICE (int i, int j, int k) noexcept { u(i,j,k) = 0.0; });
+                        amrex::ParallelFor(vbx, [v]
+                        AMREX_GPU_DEVICE (int i, int j, int k) noexcept { v(i,j,k) = 0.0; });
 #if (AMREX_SPACEDIM==3)
-                amrex::ParallelFor(wbx, [w]
-                AMREX_GPU_DEVICE (int i, int j, int k) noexcept { w(i,j,k) = 0.0; });
+                        amrex::ParallelFor(wbx, [w]
+                        AMREX_GPU_DEVICE (int i, int j, int k) noexcept { w(i,j,k) = 0.0; });
 #endif
-            }
-            else if (typ == FabType::singlevalued)
-            {
-                AMREX_D_TERM( Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
-                              Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
-                              Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
+                    }
+                    else if (typ == FabType::singlevalued)
+                    {
+                        AMREX_D_TERM( Array4<Real const> const& fcx = fcent[0]->const_array(mfi);,
+                                      Array4<Real const> const& fcy = fcent[1]->const_array(mfi);,
+                                      Array4<Real const> const& fcz = fcent[2]->const_array(mfi););
 
-                Array4<Real const> const& ccc = ccent.const_array(mfi);
-                auto vfrac = fact.getVolFrac().const_array(mfi);
+                        Array4<Real const> const& ccc = ccent.const_array(mfi);
+                        auto vfrac = fact.getVolFrac().const_array(mfi);
 
-                EBMOL::ExtrapVelToFacesBox(AMREX_D_DECL(ubx,vbx,wbx),
-                                           AMREX_D_DECL(u,v,w),vcc,flagarr,
-                                           AMREX_D_DECL(fcx,fcy,fcz),ccc, vfrac,
-                                           a_geom, h_bcrec, d_bcrec);
-            }
-            else
+                        EBMOL::ExtrapVelToFacesBox(AMREX_D_DECL(ubx,vbx,wbx),
+                                                   AMREX_D_DECL(u,v,w),vcc,flagarr,
+                                                   AMREX_D_DECL(fcx,fcy,fcz),ccc, vfrac,
+                                                   a_geom, h_bcrec, d_bcrec);
+                    }
+                    else
 #endif
-            {
-                MOL::ExtrapVelToFacesBox(AMREX_D_DECL(ubx,vbx,wbx),
-                                         AMREX_D_DECL(u,v,w),
-                                         vcc,a_geom,h_bcrec, d_bcrec);
+                    {
+                        MOL::ExtrapVelToFacesBox(AMREX_D_DECL(ubx,vbx,wbx),
+                                                 AMREX_D_DECL(u,v,w),
+                                                 vcc,a_geom,h_bcrec, d_bcrec);
+                    }
+                }
+
+                if (cfl && region != HydroUtils::TileRegion::Interior)
+                {
+                    Box const& bx = mfi.tilebox();
+#ifdef AMREX_USE_EB
+                    if (flagfab.getType(bx) != FabType::covered) {
+                        cfl->add(bx, vcc,
+                                 AMREX_D_DECL(mfi.nodaltilebox(0),
+                                              mfi.nodaltilebox(1),
+                                              mfi.nodaltilebox(2)),
+                                 AMREX_D_DECL(a_umac.const_array(mfi),
+                                              a_vmac.const_array(mfi),
+                                              a_wmac.const_array(mfi)),
+                                 flagarr);
+                    }
+#endif
+                }
             }
         }
     }
@@ -23,85 +23,109 @@ Godunov::ExtrapVelToFaces ( MultiFab const& a_vel,
                             const Vector<BCRec> & h_bcrec,
                 const        BCRec  * d_bcrec,
                             const Geometry& geom, Real l_dt,
-                            bool use_ppm, bool use_forces_in_trans)
+                            bool use_ppm, bool use_forces_in_trans,
+                            HydroUtils::AdvectiveCFLReducer* cfl,
+                            HydroUtils::TileRegion region)
 {
+    BL_PROFILE("Godunov::ExtrapVelToFaces");
+
     Box const& domain = geom.Domain();
     const Real* dx    = geom.CellSize();
 
+    // Cells read beyond a box when computing the velocities on its faces
+    const int nghost = HydroUtils::nGrowRequired("Godunov", false, "", HydroUtils::GhostField::State);
+
     const int ncomp = AMREX_SPACEDIM;
+
+    HydroUtils::TileScheduler sched(a_vel, nghost);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     {
         FArrayBox scratch;
-        for (MFIter mfi(a_vel,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        for (int pass = 0; pass < sched.numPasses(); ++pass)
         {
-            Box const& bx = mfi.tilebox();
-            Box const& bxg1 = amrex::grow(bx,1);
-
-            Box const& xbx = mfi.nodaltilebox(0);
-            Box const& ybx = mfi.nodaltilebox(1);
-            Box const& zbx = mfi.nodaltilebox(2);
-
-            Array4<Real> const& umac = a_umac.array(mfi);
-            Array4<Real> const& vmac = a_vmac.array(mfi);
-            Array4<Real> const& wmac = a_wmac.array(mfi);
-
-            Array4<Real const> const& vel = a_vel.const_array(mfi);
-            Array4<Real const> const& f   = a_forces.const_array(mfi);
-
-            scratch.resize(bxg1, (ncomp*4 + 1)*AMREX_SPACEDIM);
-            Real* p = scratch.dataPtr();
-
-            Array4<Real> Imx = makeArray4(p,bxg1,ncomp);
-            p +=         Imx.size();
-            Array4<Real> Ipx = makeArray4(p,bxg1,ncomp);
-            p +=         Ipx.size();
-            Array4<Real> Imy = makeArray4(p,bxg1,ncomp);
-            p +=         Imy.size();
-            Array4<Real> Ipy = makeArray4(p,bxg1,ncomp);
-            p +=         Ipy.size();
-            Array4<Real> Imz = makeArray4(p,bxg1,ncomp);
-            p +=         Imz.size();
-            Array4<Real> Ipz = makeArray4(p,bxg1,ncomp);
-            p +=         Ipz.size();
-            Array4<Real> u_ad = makeArray4(p,Box(bx).grow(1,1).grow(2,1).surroundingNodes(0),1);
-            p +=         u_ad.size();
-            Array4<Real> v_ad = makeArray4(p,Box(bx).grow(0,1).grow(2,1).surroundingNodes(1),1);
-            p +=         v_ad.size();
-            Array4<Real> w_ad = makeArray4(p,Box(bx).grow(0,1).grow(1,1).surroundingNodes(2),1);
-            p +=         w_ad.size();
-
-            if (use_ppm)
+            for (MFIter mfi(a_vel, sched.info()); mfi.isValid(); ++mfi)
             {
-                PPM::PredictVelOnFaces( bxg1,
-                                        Imx, Imy, Imz, Ipx, Ipy, Ipz,
-                                        vel, vel,
-                                        geom, l_dt, d_bcrec);
+                if (!sched.inPass(mfi, pass)) { continue; }
+                HydroUtils::TileScheduler::BusyTimer busy_timer(sched);
+
+                Array4<Real> const& umac = a_umac.array(mfi);
+                Array4<Real> const& vmac = a_vmac.array(mfi);
+                Array4<Real> const& wmac = a_wmac.array(mfi);
+
+                Array4<Real const> const& vel = a_vel.const_array(mfi);
+                Array4<Real const> const& f   = a_forces.const_array(mfi);
+
+                for (Box const& bx : HydroUtils::TileRegionBoxes(mfi, region, nghost))
+                {
+                    Box const& bxg1 = amrex::grow(bx,1);
+
+                    Box const& xbx = amrex::surroundingNodes(bx,0) & mfi.nodaltilebox(0);
+                    Box const& ybx = amrex::surroundingNodes(bx,1) & mfi.nodaltilebox(1);
+                    Box const& zbx = amrex::surroundingNodes(bx,2) & mfi.nodaltilebox(2);
+
+                    scratch.resize(bxg1, (ncomp*4 + 1)*AMREX_SPACEDIM);
+                    Real* p = scratch.dataPtr();
+
+                    Array4<Real> Imx = makeArray4(p,bxg1,ncomp);
+                    p +=         Imx.size();
+                    Array4<Real> Ipx = makeArray4(p,bxg1,ncomp);
+                    p +=         Ipx.size();
+                    Array4<Real> Imy = makeArray4(p,bxg1,ncomp);
+                    p +=         Imy.size();
+                    Array4<Real> Ipy = makeArray4(p,bxg1,ncomp);
+                    p +=         Ipy.size();
+                    Array4<Real> Imz = makeArray4(p,bxg1,ncomp);
+                    p +=         Imz.size();
+                    Array4<Real> Ipz = makeArray4(p,bxg1,ncomp);
+                    p +=         Ipz.size();
+                    Array4<Real> u_ad = makeArray4(p,Box(bx).grow(1,1).grow(2,1).surroundingNodes(0),1);
+                    p +=         u_ad.size();
+                    Array4<Real> v_ad = makeArray4(p,Box(bx).grow(0,1).grow(2,1).surroundingNodes(1),1);
+                    p +=         v_ad.size();
+                    Array4<Real> w_ad = makeArray4(p,Box(bx).grow(0,1).grow(1,1).surroundingNodes(2),1);
+                    p +=         w_ad.size();
+
+                    if (use_ppm)
+                    {
+                        PPM::PredictVelOnFaces( bxg1,
+                                                Imx, Imy, Imz, Ipx, Ipy, Ipz,
+                                                vel, vel,
+                                                geom, l_dt, d_bcrec);
+                    }
+                    else
+                    {
+                        PLM::PredictVelOnXFace( Box(u_ad), AMREX_SPACEDIM, Imx, Ipx, vel, vel,
+                                                 geom, l_dt, h_bcrec, d_bcrec);
+                        PLM::PredictVelOnYFace( Box(v_ad), AMREX_SPACEDIM, Imy, Ipy, vel, vel,
+                                                geom, l_dt, h_bcrec, d_bcrec);
+                        PLM::PredictVelOnZFace( Box(w_ad), AMREX_SPACEDIM, Imz, Ipz, vel, vel,
+                                                geom, l_dt, h_bcrec, d_bcrec);
+                    }
+
+                    ComputeAdvectiveVel( Box(u_ad), Box(v_ad), Box(w_ad),
+                                         u_ad, v_ad, w_ad,
+                                         Imx, Imy, Imz, Ipx, Ipy, Ipz,
+                                         vel, f, domain, l_dt, d_bcrec, use_forces_in_trans);
+
+                    ExtrapVelToFacesOnBox( bx, ncomp,
+                                           xbx, ybx, zbx,
+                                           umac, vmac, wmac, vel,
+                                           u_ad, v_ad, w_ad,
+                                           Imx, Imy, Imz, Ipx, Ipy, Ipz,
+                                           f, domain, dx, l_dt, d_bcrec, use_forces_in_trans, p);
+
+                    Gpu::streamSynchronize();  // otherwise we might be using too much memory
+                }
+
+                if (cfl && region != HydroUtils::TileRegion::Interior) {
+                    cfl->add(mfi.tilebox(), vel,
+                             mfi.nodaltilebox(0), mfi.nodaltilebox(1), mfi.nodaltilebox(2),
+                             umac, vmac, wmac);
+                }
             }
-            else
-            {
-                PLM::PredictVelOnXFace( Box(u_ad), AMREX_SPACEDIM, Imx, Ipx, vel, vel,
-                                         geom, l_dt, h_bcrec, d_bcrec);
-                PLM::PredictVelOnYFace( Box(v_ad), AMREX_SPACEDIM, Imy, Ipy, vel, vel,
-                                        geom, l_dt, h_bcrec, d_bcrec);
-                PLM::PredictVelOnZFace( Box(w_ad), AMREX_SPACEDIM, Imz, Ipz, vel, vel,
-                                        geom, l_dt, h_bcrec, d_bcrec);
-            }
-
-            ComputeAdvectiveVel( Box(u_ad), Box(v_ad), Box(w_ad),
-                                 u_ad, v_ad, w_ad,
-                                 Imx, Imy, Imz, Ipx, Ipy, Ipz,
-                                 vel, f, domain, l_dt, d_bcrec, use_forces_in_trans);
-
-            ExtrapVelToFacesOnBox( bx, ncomp,
-                                   xbx, ybx, zbx,
-                                   umac, vmac, wmac, vel,
-                                   u_ad, v_ad, w_ad,
-                                   Imx, Imy, Imz, Ipx, Ipy, Ipz,
-                                   f, domain, dx, l_dt, d_bcrec, use_forces_in_trans, p);
-
-            Gpu::streamSynchronize();  // otherwise we might be using too much memory
         }
     }
 }
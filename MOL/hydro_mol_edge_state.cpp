@@ -4,6 +4,7 @@
 
 #include <hydro_mol.H>
 #include <hydro_mol_edge_state_K.H>
+#include <hydro_utils.H>
 
 using namespace amrex;
 
@@ -24,6 +25,46 @@ namespace {
 
 
 
+Array4<Real const>
+MOL::ComputeSlopes ( FArrayBox& slope_fab, Box const& fbx, int dir,
+                     Array4<Real const> const& q, int scomp, int ncomp )
+{
+    constexpr int order = 2;
+
+    const Box sbx = amrex::grow(amrex::enclosedCells(fbx), dir, 1);
+    slope_fab.resize(sbx, ncomp, The_Async_Arena());
+    Array4<Real> const& slope = slope_fab.array();
+
+    if (dir == 0)
+    {
+        amrex::ParallelFor(sbx, ncomp, [q,slope,scomp]
+        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            slope(i,j,k,n) = amrex_calc_xslope(i, j, k, n+scomp, order, q);
+        });
+    }
+    else if (dir == 1)
+    {
+        amrex::ParallelFor(sbx, ncomp, [q,slope,scomp]
+        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            slope(i,j,k,n) = amrex_calc_yslope(i, j, k, n+scomp, order, q);
+        });
+    }
+#if (AMREX_SPACEDIM==3)
+    else
+    {
+        amrex::ParallelFor(sbx, ncomp, [q,slope,scomp]
+        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            slope(i,j,k,n) = amrex_calc_zslope(i, j, k, n+scomp, order, q);
+        });
+    }
+#endif
+
+    return slope_fab.const_array();
+}
+
 //
 // Compute edge state on REGULAR box
 //
@@ -55,89 +96,141 @@ MOL::ComputeEdgeState (const Box& bx,
                   const Box& vbx = amrex::surroundingNodes(bx,1);,
                   const Box& wbx = amrex::surroundingNodes(bx,2););
 
+    // On the CPU, compute the slope of each cell once and let the face kernels
+    // read it, rather than having every face recompute the slopes of both of
+    // its neighbors. On the GPU the extra pass through memory is not worth it.
+    const bool precompute_slopes = Gpu::notInLaunchRegion();
+    FArrayBox slope_fab;
+
     // At an ext_dir boundary, the boundary value is on the face, not cell center.
+    // Only the faces whose stencil reaches the first or last cell of the domain
+    // need the ext_dir/hoextrap aware kernel; the interior of the box can always
+    // use the plain one, so we split off the boundary slabs rather than switch
+    // the whole box to the slower kernel.
+    Vector<Box> slabs;
+
     auto extdir_lohi = has_extdir_or_ho(bcs.dataPtr(), ncomp, 0);
     bool has_extdir_or_ho_lo = extdir_lohi.first;
     bool has_extdir_or_ho_hi = extdir_lohi.second;
 
+    Box ubx_interior = ubx;
     if ((has_extdir_or_ho_lo && domain_ilo >= ubx.smallEnd(0)-1) ||
         (has_extdir_or_ho_hi && domain_ihi <= ubx.bigEnd(0)))
     {
-        amrex::ParallelFor(ubx, ncomp, [d_bcrec_ptr,q,domain_ilo,domain_ihi,umac,xedge,is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        const Array<bool,AMREX_SPACEDIM> bc_slab{AMREX_D_DECL(true,false,false)};
+        ubx_interior = HydroUtils::SplitBoundarySlabs(ubx, domain, bc_slab, bc_slab, slabs);
+
+        for (Box const& sbx : slabs)
         {
-            xedge(i,j,k,n) = MOL::hydro_mol_xedge_state_extdir( i, j, k, n, q, umac,
-                                                                d_bcrec_ptr,
-                                                                domain_ilo, domain_ihi,
-                                                                is_velocity);
-        });
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,domain_ilo,domain_ihi,umac,xedge,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                xedge(i,j,k,n) = MOL::hydro_mol_xedge_state_extdir( i, j, k, n, q, umac,
+                                                                    d_bcrec_ptr,
+                                                                    domain_ilo, domain_ihi,
+                                                                    is_velocity);
+            });
+        }
     }
-    else
+
+    if (ubx_interior.ok())
     {
-        amrex::ParallelFor(ubx, ncomp, [d_bcrec_ptr,q,domain_ilo,domain_ihi,umac,xedge,is_velocity]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, ubx_interior, 0, q, 0, ncomp);
+        }
+
+        amrex::ParallelFor(ubx_interior, ncomp, [d_bcrec_ptr,q,domain_ilo,domain_ihi,umac,xedge,is_velocity,slope]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             xedge(i,j,k,n) = MOL::hydro_mol_xedge_state( i, j, k, n, q, umac,
                                                          d_bcrec_ptr,
                                                          domain_ilo, domain_ihi,
-                                                         is_velocity);
+                                                         is_velocity, slope);
         });
     }
 
     extdir_lohi = has_extdir_or_ho(bcs.dataPtr(), ncomp, 1);
     has_extdir_or_ho_lo = extdir_lohi.first;
     has_extdir_or_ho_hi = extdir_lohi.second;
+
+    Box vbx_interior = vbx;
     if ((has_extdir_or_ho_lo && domain_jlo >= vbx.smallEnd(1)-1) ||
         (has_extdir_or_ho_hi && domain_jhi <= vbx.bigEnd(1)))
     {
-        amrex::ParallelFor(vbx, ncomp, [d_bcrec_ptr,q,domain_jlo,domain_jhi,vmac,yedge,is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        const Array<bool,AMREX_SPACEDIM> bc_slab{AMREX_D_DECL(false,true,false)};
+        vbx_interior = HydroUtils::SplitBoundarySlabs(vbx, domain, bc_slab, bc_slab, slabs);
+
+        for (Box const& sbx : slabs)
         {
-            yedge(i,j,k,n) = MOL::hydro_mol_yedge_state_extdir( i, j, k, n, q, vmac,
-                                                                d_bcrec_ptr,
-                                                                domain_jlo, domain_jhi,
-                                                                is_velocity);
-        });
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,domain_jlo,domain_jhi,vmac,yedge,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                yedge(i,j,k,n) = MOL::hydro_mol_yedge_state_extdir( i, j, k, n, q, vmac,
+                                                                    d_bcrec_ptr,
+                                                                    domain_jlo, domain_jhi,
+                                                                    is_velocity);
+            });
+        }
     }
-    else
+
+    if (vbx_interior.ok())
     {
-        amrex::ParallelFor(vbx, ncomp, [d_bcrec_ptr,q,domain_jlo,domain_jhi,vmac,yedge,is_velocity]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, vbx_interior, 1, q, 0, ncomp);
+        }
+
+        amrex::ParallelFor(vbx_interior, ncomp, [d_bcrec_ptr,q,domain_jlo,domain_jhi,vmac,yedge,is_velocity,slope]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             yedge(i,j,k,n) = MOL::hydro_mol_yedge_state( i, j, k, n, q, vmac,
                                                          d_bcrec_ptr,
                                                          domain_jlo, domain_jhi,
-                                                         is_velocity);
+                                                         is_velocity, slope);
         });
     }
 
-
 #if ( AMREX_SPACEDIM ==3 )
 
     extdir_lohi = has_extdir_or_ho(bcs.dataPtr(), ncomp, 2);
     has_extdir_or_ho_lo = extdir_lohi.first;
     has_extdir_or_ho_hi = extdir_lohi.second;
+
+    Box wbx_interior = wbx;
     if ((has_extdir_or_ho_lo && domain_klo >= wbx.smallEnd(2)-1) ||
         (has_extdir_or_ho_hi && domain_khi <= wbx.bigEnd(2)))
     {
-        amrex::ParallelFor(wbx, ncomp, [d_bcrec_ptr,q,domain_klo,domain_khi,wmac,zedge,is_velocity]
-        AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        const Array<bool,AMREX_SPACEDIM> bc_slab{AMREX_D_DECL(false,false,true)};
+        wbx_interior = HydroUtils::SplitBoundarySlabs(wbx, domain, bc_slab, bc_slab, slabs);
+
+        for (Box const& sbx : slabs)
         {
-            zedge(i,j,k,n) = MOL::hydro_mol_zedge_state_extdir( i, j, k, n, q, wmac,
-                                                                d_bcrec_ptr,
-                                                                domain_klo, domain_khi,
-                                                                is_velocity);
-        });
+            amrex::ParallelFor(sbx, ncomp, [d_bcrec_ptr,q,domain_klo,domain_khi,wmac,zedge,is_velocity]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                zedge(i,j,k,n) = MOL::hydro_mol_zedge_state_extdir( i, j, k, n, q, wmac,
+                                                                    d_bcrec_ptr,
+                                                                    domain_klo, domain_khi,
+                                                                    is_velocity);
+            });
+        }
     }
-    else
+
+    if (wbx_interior.ok())
     {
-        amrex::ParallelFor(wbx, ncomp, [d_bcrec_ptr,q,domain_klo,domain_khi,wmac,zedge,is_velocity]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, wbx_interior, 2, q, 0, ncomp);
+        }
+
+        amrex::ParallelFor(wbx_interior, ncomp, [d_bcrec_ptr,q,domain_klo,domain_khi,wmac,zedge,is_velocity,slope]
         AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             zedge(i,j,k,n) = MOL::hydro_mol_zedge_state( i, j, k, n, q, wmac,
                                                          d_bcrec_ptr,
                                                          domain_klo, domain_khi,
-                                                         is_velocity);
+                                                         is_velocity, slope);
         });
     }
 
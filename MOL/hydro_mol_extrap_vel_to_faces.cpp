@@ -21,28 +21,55 @@ MOL::ExtrapVelToFaces ( const MultiFab&  a_vel,
                                       MultiFab& a_wmac ),
                         const Geometry&  a_geom,
             const Vector<BCRec>& h_bcrec,
-                        BCRec  const* d_bcrec)
+                        BCRec  const* d_bcrec,
+                        HydroUtils::AdvectiveCFLReducer* cfl,
+                        HydroUtils::TileRegion region)
 {
     BL_PROFILE("MOL::ExtrapVelToFaces");
 
+    // Cells read beyond a box when computing the velocities on its faces
+    const int nghost = HydroUtils::nGrowRequired("MOL", false, "", HydroUtils::GhostField::State);
+
+    HydroUtils::TileScheduler sched(a_vel, nghost);
+
 #ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
     {
-        for (MFIter mfi(a_vel, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        for (int pass = 0; pass < sched.numPasses(); ++pass)
         {
-            AMREX_D_TERM( Box const& ubx = mfi.nodaltilebox(0);,
-                          Box const& vbx = mfi.nodaltilebox(1);,
-                          Box const& wbx = mfi.nodaltilebox(2););
-
-            AMREX_D_TERM( Array4<Real> const& u = a_umac.array(mfi);,
-                          Array4<Real> const& v = a_vmac.array(mfi);,
-                          Array4<Real> const& w = a_wmac.array(mfi););
-
-            Array4<Real const> const& vcc = a_vel.const_array(mfi);
-            ExtrapVelToFacesBox( AMREX_D_DECL(ubx,vbx,wbx),
-                                 AMREX_D_DECL(u,v,w),
-                                 vcc,a_geom,h_bcrec, d_bcrec);
+            for (MFIter mfi(a_vel, sched.info()); mfi.isValid(); ++mfi)
+            {
+                if (!sched.inPass(mfi, pass)) { continue; }
+                HydroUtils::TileScheduler::BusyTimer busy_timer(sched);
+
+                AMREX_D_TERM( Array4<Real> const& u = a_umac.array(mfi);,
+                              Array4<Real> const& v = a_vmac.array(mfi);,
+                              Array4<Real> const& w = a_wmac.array(mfi););
+
+                Array4<Real const> const& vcc = a_vel.const_array(mfi);
+
+                for (Box const& bx : HydroUtils::TileRegionBoxes(mfi, region, nghost))
+                {
+                    AMREX_D_TERM( Box const& ubx = amrex::surroundingNodes(bx,0) & mfi.nodaltilebox(0);,
+                                  Box const& vbx = amrex::surroundingNodes(bx,1) & mfi.nodaltilebox(1);,
+                                  Box const& wbx = amrex::surroundingNodes(bx,2) & mfi.nodaltilebox(2););
+
+                    ExtrapVelToFacesBox( AMREX_D_DECL(ubx,vbx,wbx),
+                                         AMREX_D_DECL(u,v,w),
+                                         vcc,a_geom,h_bcrec, d_bcrec);
+                }
+
+                if (cfl && region != HydroUtils::TileRegion::Interior) {
+                    cfl->add(mfi.tilebox(), vcc,
+                             AMREX_D_DECL(mfi.nodaltilebox(0),
+                                          mfi.nodaltilebox(1),
+                                          mfi.nodaltilebox(2)),
+                             AMREX_D_DECL(a_umac.const_array(mfi),
+                                          a_vmac.const_array(mfi),
+                                          a_wmac.const_array(mfi)));
+                }
+            }
         }
 
     }
@@ -60,6 +60,12 @@ MOL::ExtrapVelToFacesBox (  AMREX_D_DECL( Box const& ubx,
 
     constexpr int order = 2;
 
+    // On the CPU, compute the slope of each cell once and let the face kernels
+    // read it, rather than having every face recompute the slopes of both of
+    // its neighbors. On the GPU the extra pass through memory is not worth it.
+    const bool precompute_slopes = Gpu::notInLaunchRegion();
+    FArrayBox slope_fab;
+
     // At an ext_dir or hoextrap boundary,
     //    the boundary value is on the face, not cell center.
     auto extdir_lohi = has_extdir_or_ho(h_bcrec.data(), ncomp, static_cast<int>(Direction::x));
@@ -127,13 +133,22 @@ MOL::ExtrapVelToFacesBox (  AMREX_D_DECL( Box const& ubx,
     }
     else
     {
-        amrex::ParallelFor(ubx, [vcc,domain_ilo,domain_ihi,u,d_bcrec]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, ubx, 0, vcc, 0, 1);
+        }
+
+        amrex::ParallelFor(ubx, [vcc,domain_ilo,domain_ihi,u,d_bcrec,slope]
         AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             constexpr int     n = 0;
 
-            Real upls = vcc(i  ,j,k,0) - 0.5 * amrex_calc_xslope(i  ,j,k,0,order,vcc);
-            Real umns = vcc(i-1,j,k,0) + 0.5 * amrex_calc_xslope(i-1,j,k,0,order,vcc);
+            const bool has_slope = (slope.dataPtr() != nullptr);
+
+            Real upls = vcc(i  ,j,k,0) - 0.5 * ( has_slope ? slope(i  ,j,k,0)
+                                                        : amrex_calc_xslope(i  ,j,k,0,order,vcc) );
+            Real umns = vcc(i-1,j,k,0) + 0.5 * ( has_slope ? slope(i-1,j,k,0)
+                                                        : amrex_calc_xslope(i-1,j,k,0,order,vcc) );
 
             HydroBC::SetXEdgeBCs(i, j, k, n, vcc, umns, upls, d_bcrec[0].lo(0), domain_ilo, d_bcrec[0].hi(0), domain_ihi, true);
 
@@ -234,13 +249,22 @@ MOL::ExtrapVelToFacesBox (  AMREX_D_DECL( Box const& ubx,
     }
     else
     {
-        amrex::ParallelFor(vbx, [vcc,domain_jlo,domain_jhi,v,d_bcrec]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, vbx, 1, vcc, 1, 1);
+        }
+
+        amrex::ParallelFor(vbx, [vcc,domain_jlo,domain_jhi,v,d_bcrec,slope]
         AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             constexpr int     n = 1;
 
-            Real vpls = vcc(i,j  ,k,1) - 0.5 * amrex_calc_yslope(i,j  ,k,1,order,vcc);
-            Real vmns = vcc(i,j-1,k,1) + 0.5 * amrex_calc_yslope(i,j-1,k,1,order,vcc);
+            const bool has_slope = (slope.dataPtr() != nullptr);
+
+            Real vpls = vcc(i,j  ,k,1) - 0.5 * ( has_slope ? slope(i,j  ,k,0)
+                                                        : amrex_calc_yslope(i,j  ,k,1,order,vcc) );
+            Real vmns = vcc(i,j-1,k,1) + 0.5 * ( has_slope ? slope(i,j-1,k,0)
+                                                        : amrex_calc_yslope(i,j-1,k,1,order,vcc) );
 
             HydroBC::SetYEdgeBCs(i, j, k, n, vcc, vmns, vpls, d_bcrec[1].lo(1), domain_jlo, d_bcrec[1].hi(1), domain_jhi, true);
 
@@ -341,13 +365,22 @@ MOL::ExtrapVelToFacesBox (  AMREX_D_DECL( Box const& ubx,
     }
     else
     {
-        amrex::ParallelFor(wbx, [vcc,domain_klo,domain_khi,w,d_bcrec]
+        Array4<Real const> slope;
+        if (precompute_slopes) {
+            slope = MOL::ComputeSlopes(slope_fab, wbx, 2, vcc, 2, 1);
+        }
+
+        amrex::ParallelFor(wbx, [vcc,domain_klo,domain_khi,w,d_bcrec,slope]
         AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
             constexpr int     n = 2;
 
-            Real wpls = vcc(i,j,k  ,2) - 0.5 * amrex_calc_zslope(i,j,k  ,2,order,vcc);
-            Real wmns = vcc(i,j,k-1,2) + 0.5 * amrex_calc_zslope(i,j,k-1,2,order,vcc);
+            const bool has_slope = (slope.dataPtr() != nullptr);
+
+            Real wpls = vcc(i,j,k  ,2) - 0.5 * ( has_slope ? slope(i,j,k  ,0)
+                                                        : amrex_calc_zslope(i,j,k  ,2,order,vcc) );
+            Real wmns = vcc(i,j,k-1,2) + 0.5 * ( has_slope ? slope(i,j,k-1,0)
+                                                        : amrex_calc_zslope(i,j,k-1,2,order,vcc) );
 
             HydroBC::SetZEdgeBCs(i, j, k, n, vcc, wmns, wpls, d_bcrec[2].lo(2), domain_klo, d_bcrec[2].hi(2), domain_khi, true);
 
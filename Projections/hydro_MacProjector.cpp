@@ -65,24 +65,28 @@ void MacProjector::initProjector (
     }
 
     m_rhs.resize(nlevs);
-    m_phi.resize(nlevs);
     m_fluxes.resize(nlevs);
     m_divu.resize(nlevs);
 
+    m_lpinfo = a_lpinfo;
+    m_has_overset_mask = !a_overset_mask.empty();
+    m_level_bc.clear();
+    m_level_bc.resize(nlevs, nullptr);
+    m_batch_ncomp = 0;
+
 #ifdef AMREX_USE_EB
     bool has_eb = a_beta[0][0]->hasEBFabFactory();
     if (has_eb) {
         m_eb_vel.resize(nlevs);
         m_eb_factory.resize(nlevs, nullptr);
+        m_eb_factory_clone.resize(nlevs);
         for (int ilev = 0; ilev < nlevs; ++ilev) {
+            m_eb_factory_clone[ilev].reset(a_beta[ilev][0]->Factory().clone());
             m_eb_factory[ilev] = dynamic_cast<EBFArrayBoxFactory const*>(
-                &(a_beta[ilev][0]->Factory()));
+                m_eb_factory_clone[ilev].get());
             m_rhs[ilev].define(
                 ba[ilev], dm[ilev], 1, 0, MFInfo(), a_beta[ilev][0]->Factory());
-            m_phi[ilev].define(
-                ba[ilev], dm[ilev], 1, 1, MFInfo(), a_beta[ilev][0]->Factory());
             m_rhs[ilev].setVal(0.0);
-            m_phi[ilev].setVal(0.0);
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                 m_fluxes[ilev][idim].define(
                     amrex::convert(ba[ilev], IntVect::TheDimensionVector(idim)),
@@ -105,9 +109,7 @@ void MacProjector::initProjector (
     {
         for (int ilev = 0; ilev < nlevs; ++ilev) {
             m_rhs[ilev].define(ba[ilev], dm[ilev], 1, 0);
-            m_phi[ilev].define(ba[ilev], dm[ilev], 1, 1);
             m_rhs[ilev].setVal(0.0);
-            m_phi[ilev].setVal(0.0);
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                 m_fluxes[ilev][idim].define(
                     amrex::convert(ba[ilev], IntVect::TheDimensionVector(idim)),
@@ -130,8 +132,11 @@ void MacProjector::initProjector (
     }
 
     m_mlmg = std::make_unique<MLMG>(*m_linop);
+    m_precond_mlmg.reset();
+    m_refine_mlmg.reset();
 
     setOptions();
+    definePhi();
 
     m_needs_init = false;
 }
@@ -159,6 +164,10 @@ void MacProjector::updateBeta (
         for (int ilev=0; ilev < nlevs; ++ilev)
             m_abeclap->setBCoeffs(ilev, a_beta[ilev]);
     }
+
+    // The batched and single precision operators hold their own copies of beta
+    m_batch_ncomp = 0;
+    m_refine_mlmg.reset();
 }
 
 void MacProjector::setUMAC(
@@ -188,6 +197,8 @@ void MacProjector::setDivU(const Vector<MultiFab const*>& a_divu)
 #endif
             }
             MultiFab::Copy(m_divu[ilev], *a_divu[ilev], 0, 0, 1, 0);
+        } else {
+            m_divu[ilev].clear();
         }
     }
 }
@@ -201,6 +212,10 @@ MacProjector::setDomainBC (const Array<LinOpBCType,AMREX_SPACEDIM>& lobc,
         "MacProjector::setDomainBC: initProjector must be called before calling this method");
     m_linop->setDomainBC(lobc, hibc);
     m_needs_domain_bcs = false;
+    m_lobc = lobc;
+    m_hibc = hibc;
+    m_batch_ncomp = 0;
+    m_refine_mlmg.reset();
 }
 
 
@@ -211,115 +226,550 @@ MacProjector::setLevelBC (int amrlev, const MultiFab* levelbcdata)
                                      "setDomainBC must be called before setLevelBC");
     m_linop->setLevelBC(amrlev, levelbcdata);
     m_needs_level_bcs[amrlev] = false;
+
+    // Kept for operators built later, like m_crse_bc
+    m_level_bc[amrlev] = levelbcdata;
+    m_batch_ncomp = 0;
 }
 
 
 
+//
+// Set rhs_mf to scale*(divu - div(umac)) on level ilev and, if zero_phi, reset
+// phi_mf to zero.
+//
+// For mlabeclaplacian, we solve -del dot (beta grad phi) = rhs
+//   and set up RHS as (m_divu - divu), where m_divu is a user-provided source term
+// For mlpoisson, we solve `del dot grad phi = rhs/(-const_beta)`
+//   and set up RHS as (m_divu - divu)*(-1/const_beta)
+//
+// Where the divergence is a plain face difference (no cut cells, no EB inflow,
+// Cartesian coordinates) it is computed inside the same kernel as the rest of the
+// RHS. Otherwise div(umac) is computed into m_rhs first and the kernel finishes
+// the assembly from there.
+//
 void
-MacProjector::project (Real reltol, Real atol)
+MacProjector::assembleRHS (int ilev, Array<MultiFab*,AMREX_SPACEDIM> const& umac,
+                           MultiFab& rhs_mf, MultiFab& phi_mf, bool zero_phi,
+                           ProjectionStats& stats)
 {
-    const int nlevs = m_rhs.size();
+    AMREX_ASSERT(m_poisson == nullptr || m_const_beta != Real(0.0));
+    const Real scale = m_poisson ? Real(-1.0)/m_const_beta : Real(1.0);
 
-    for (int ilev = 0; ilev < nlevs; ++ilev) {
-        if (m_needs_level_bcs[ilev]) {
-            m_linop->setLevelBC(ilev, nullptr);
-            m_needs_level_bcs[ilev] = false;
-        }
-    }
+    const bool has_umac = (umac[0] != nullptr);
+    const bool has_divu = m_divu[ilev].ok();
 
-    if ( m_umac[0][0] )
-      averageDownVelocity();
+    bool fused_div = has_umac && !m_geom[ilev].IsRZ();
+#ifdef AMREX_USE_EB
+    const bool has_eb = !m_eb_factory.empty() && m_eb_factory[ilev] != nullptr;
+    if (has_eb && (m_eb_vel[ilev] || !m_eb_factory[ilev]->isAllRegular())) {
+        fused_div = false;
+    }
+#endif
 
-    for (int ilev = 0; ilev < nlevs; ++ilev)
+    if (has_umac && !fused_div)
     {
-      if ( m_umac[0][0] )
-      {
         Array<MultiFab const*, AMREX_SPACEDIM> u;
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            u[idim] = m_umac[ilev][idim];
+            u[idim] = umac[idim];
         }
 #ifdef AMREX_USE_EB
         if (m_umac_loc != MLMG::Location::FaceCentroid)
         {
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_umac[ilev][idim]->nGrow() > 0,
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(umac[idim]->nGrow() > 0,
                                                  "MacProjector: with EB, umac must have at least one ghost cell if not already_on_centroid");
-                m_umac[ilev][idim]->FillBoundary(m_geom[ilev].periodicity());
+                umac[idim]->FillBoundary(m_geom[ilev].periodicity());
+                ++stats.num_fill_boundary;
             }
         }
 
         if (m_eb_vel[ilev]) {
-           EB_computeDivergence(m_rhs[ilev], u, m_geom[ilev], (m_umac_loc == MLMG::Location::FaceCentroid), *m_eb_vel[ilev]);
+           EB_computeDivergence(rhs_mf, u, m_geom[ilev], (m_umac_loc == MLMG::Location::FaceCentroid), *m_eb_vel[ilev]);
         } else {
-           EB_computeDivergence(m_rhs[ilev], u, m_geom[ilev], (m_umac_loc == MLMG::Location::FaceCentroid));
+           EB_computeDivergence(rhs_mf, u, m_geom[ilev], (m_umac_loc == MLMG::Location::FaceCentroid));
         }
 #else
-        computeDivergence(m_rhs[ilev], u, m_geom[ilev]);
+        amrex::ignore_unused(stats);
+        computeDivergence(rhs_mf, u, m_geom[ilev]);
 #endif
+    }
 
-        // For mlabeclaplacian, we solve -del dot (beta grad phi) = rhs
-        //   and set up RHS as (m_divu - divu), where m_divu is a user-provided source term
-        // For mlpoisson, we solve `del dot grad phi = rhs/(-const_beta)`
-        //   and set up RHS as (m_divu - divu)*(-1/const_beta)
-        AMREX_ASSERT(m_poisson == nullptr || m_const_beta != Real(0.0));
-        m_rhs[ilev].mult(m_poisson ? Real(1.0)/m_const_beta : Real(-1.0));
-      }
-      //else m_rhs already initialized to 0
+    const auto dxinv = m_geom[ilev].InvCellSizeArray();
 
-      if (m_divu[ilev].ok())
-      {
-        MultiFab::Saxpy(m_rhs[ilev], m_poisson ? Real(-1.0)/m_const_beta : Real(1.0),
-                        m_divu[ilev], 0, 0, 1, 0);
-      }
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(phi_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Box const& bx  = mfi.tilebox();
+        // Unless phi is the initial guess, reset it to zero, including its ghost cells.
+        // This is needed to handle the situation where the MacProjector is being reused.
+        Box const& gbx = mfi.growntilebox();
+
+        Array4<Real> const& rhs = rhs_mf.array(mfi);
+        Array4<Real> const& phi = phi_mf.array(mfi);
+        Array4<Real const> const& divu = has_divu ? m_divu[ilev].const_array(mfi)
+                                                  : Array4<Real const>{};
+
+        AMREX_D_TERM(Array4<Real const> const& u = fused_div ? umac[0]->const_array(mfi)
+                                                             : Array4<Real const>{};,
+                     Array4<Real const> const& v = fused_div ? umac[1]->const_array(mfi)
+                                                             : Array4<Real const>{};,
+                     Array4<Real const> const& w = fused_div ? umac[2]->const_array(mfi)
+                                                             : Array4<Real const>{};);
+
+        amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (zero_phi) { phi(i,j,k) = Real(0.0); }
+
+            if (bx.contains(IntVect(AMREX_D_DECL(i,j,k))))
+            {
+                Real div = Real(0.0);
+                if (fused_div) {
+                    div = AMREX_D_TERM(  dxinv[0]*(u(i+1,j,k) - u(i,j,k)),
+                                       + dxinv[1]*(v(i,j+1,k) - v(i,j,k)),
+                                       + dxinv[2]*(w(i,j,k+1) - w(i,j,k)));
+                } else if (has_umac) {
+                    div = rhs(i,j,k);
+                }
+                const Real src = divu ? divu(i,j,k) : Real(0.0);
+                rhs(i,j,k) = scale*(src - div);
+            }
+        });
+    }
+}
+
+ProjectionStats
+MacProjector::project (Real reltol, Real atol)
+{
+    BL_PROFILE("MacProjector::project");
 
-      // Always reset initial phi to be zero. This is needed to handle the
-      // situation where the MacProjector is being reused.
-      m_phi[ilev].setVal(0.0);
+    const int nlevs = m_rhs.size();
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_phi[0].isDefined(),
+                                     "MacProjector: with alias_phi, phi must be passed to project");
+
+    if (m_tuner.isEnabled()) {
+        applyTuner();
     }
 
-    m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol, atol);
+    // Only wait for the GPU if the timings are asked for or drive the tuner
+    const bool sync = m_timing || m_tuner.isTuning();
+
+    ProjectionStats stats;
+    Real t0 = ProjectionStats::clock(sync);
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        if (m_needs_level_bcs[ilev]) {
+            m_linop->setLevelBC(ilev, nullptr);
+            m_needs_level_bcs[ilev] = false;
+        }
+    }
+
+    if ( m_umac[0][0] ) {
+      averageDownVelocity(m_umac);
+      Real t1 = ProjectionStats::clock(sync);
+      stats.time_average_down += t1 - t0;
+      t0 = t1;
+    }
+
+    BL_PROFILE_VAR("MacProjector::project::rhs", mac_rhs);
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        assembleRHS(ilev, m_umac[ilev], m_rhs[ilev], m_phi[ilev], !m_use_initial_guess, stats);
+    }
+
+    Real reltol_used = reltol;
+    if (!m_tol_control.isFixed())
+    {
+        Real rhs_norm = 0.0;
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            rhs_norm = amrex::max(rhs_norm, m_rhs[ilev].norm0(0, 0, true));
+        }
+        ParallelDescriptor::ReduceRealMax(rhs_norm);
+
+        reltol_used = m_tol_control.chooseReltol(reltol, rhs_norm);
+        if (m_verbose > 0) {
+            amrex::Print() << "MacProjector: using reltol = " << reltol_used << std::endl;
+        }
+    }
+    stats.reltol = reltol_used;
+
+    Real t1 = ProjectionStats::clock(sync);
+    stats.time_rhs = t1 - t0;
+    t0 = t1;
+
+    BL_PROFILE_VAR_STOP(mac_rhs);
+    BL_PROFILE_VAR("MacProjector::project::solve", mac_solve);
+
+    ProjectionStats top_stats;
+    const bool use_top_solver = m_top_solver.isActive(nlevs);
+    const bool use_refine = use_top_solver && (m_top_solver.type() == ProjectionKrylov::Type::Refine);
+    if (use_refine)
+    {
+        setupRefine();
+        top_stats = m_top_solver.refine(*m_linop, *m_mlmg, *m_refine_mlmg, m_phi[0], m_rhs[0],
+                                        reltol_used, atol, m_verbose);
+    }
+    else if (use_top_solver)
+    {
+        if (!m_precond_mlmg) {
+            m_precond_mlmg = std::make_unique<MLMG>(*m_linop);
+            setSolverOptions(*m_linop, *m_precond_mlmg);
+        }
+        top_stats = m_top_solver.solve(*m_linop, *m_precond_mlmg, m_phi[0], m_rhs[0],
+                                       reltol_used, atol, m_verbose);
+    }
+
+    // After a Krylov solve this normally takes no iterations, but it checks the
+    // solution and leaves MLMG ready for getFluxes
+    m_mlmg->solve(amrex::GetVecOfPtrs(m_phi), amrex::GetVecOfConstPtrs(m_rhs), reltol_used, atol);
+
+    BL_PROFILE_VAR_STOP(mac_solve);
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_solve        = t1 - t0;
+    stats.num_solves        = 1;
+    stats.iterations        = top_stats.iterations + m_mlmg->getNumIters();
+    stats.bottom_iterations = m_mlmg->getNumCGIters();
+    stats.krylov_iterations = top_stats.krylov_iterations;
+    stats.initial_residual  = use_top_solver ? top_stats.initial_residual
+                                             : m_mlmg->getInitResidual();
+    stats.final_residual    = m_mlmg->getFinalResidual();
+    m_tuner.record(stats, m_verbose);
+    t0 = t1;
 
     if ( m_umac[0][0] )
     {
+      BL_PROFILE_VAR("MacProjector::project::fluxes", mac_fluxes);
+
       m_mlmg->getFluxes(amrex::GetVecOfArrOfPtrs(m_fluxes), m_umac_loc);
 
-      for (int ilev = 0; ilev < nlevs; ++ilev) {
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-            if (m_poisson) {
-                MultiFab::Saxpy(*m_umac[ilev][idim], m_const_beta, m_fluxes[ilev][idim], 0,0,1,0);
-            } else {
-                MultiFab::Add(*m_umac[ilev][idim], m_fluxes[ilev][idim], 0, 0, 1, 0);
-            }
-#ifdef AMREX_USE_EB
-            EB_set_covered_faces(m_umac[ilev], 0.0);
-#endif
-        }
-      }
+      correctVelocity(m_umac, m_fluxes, 0);
 
-      averageDownVelocity();
+      BL_PROFILE_VAR_STOP(mac_fluxes);
+
+      t1 = ProjectionStats::clock(sync);
+      stats.time_fluxes = t1 - t0;
+      t0 = t1;
+
+      averageDownVelocity(m_umac);
+
+      stats.time_average_down += ProjectionStats::clock(sync) - t0;
     }
 
+    return stats;
 }
 
 void
+MacProjector::writePhi (std::string const& a_dir) const
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_alias_phi, "MacProjector::writePhi: not available with alias_phi");
+    writeProjectionPhi(a_dir, amrex::GetVecOfConstPtrs(m_phi));
+}
+
+int
+MacProjector::readPhi (std::string const& a_dir)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_alias_phi, "MacProjector::readPhi: not available with alias_phi");
+    const int nread = readProjectionPhi(a_dir, amrex::GetVecOfPtrs(m_phi), m_geom);
+    if (nread > 0) {
+        m_use_initial_guess = true;
+    }
+    return nread;
+}
+
+ProjectionStats
 MacProjector::project (const Vector<MultiFab*>& phi_inout, Real reltol, Real atol)
 {
     const int nlevs = m_rhs.size();
+
+    if (m_alias_phi)
+    {
+        bindPhi(phi_inout);
+
+        ProjectionStats stats = project(reltol, atol);
+
+        // Do not keep pointing to the caller's data
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            m_phi[ilev].clear();
+        }
+
+        return stats;
+    }
+
     for (int ilev = 0; ilev < nlevs; ++ilev) {
         MultiFab::Copy(m_phi[ilev], *phi_inout[ilev], 0, 0, 1, 0);
     }
 
-    project(reltol, atol);
+    ProjectionStats stats = project(reltol, atol);
 
     for (int ilev = 0; ilev < nlevs; ++ilev) {
         MultiFab::Copy(*phi_inout[ilev], m_phi[ilev], 0, 0, 1, 0);
     }
+
+    return stats;
+}
+
+//
+// Allocate phi, unless the projector solves into the phi passed to project
+//
+void
+MacProjector::definePhi ()
+{
+    const int nlevs = m_rhs.size();
+    m_phi.clear();
+    m_phi.resize(nlevs);
+
+    if (m_alias_phi) { return; }
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        m_phi[ilev].define(m_rhs[ilev].boxArray(), m_rhs[ilev].DistributionMap(), 1, 1,
+                           MFInfo(), m_rhs[ilev].Factory());
+        m_phi[ilev].setVal(0.0);
+    }
+}
+
+void
+MacProjector::setAliasPhi (bool a_alias)
+{
+    if (a_alias == m_alias_phi) { return; }
+    m_alias_phi = a_alias;
+    definePhi();
+}
+
+//
+// Make m_phi an alias of the first component of a_phi, after checking that a_phi
+// can be solved into directly
+//
+void
+MacProjector::bindPhi (const Vector<MultiFab*>& a_phi)
+{
+    const int nlevs = m_rhs.size();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_phi.size() == nlevs,
+                                     "MacProjector: phi must have one MultiFab per level");
+
+    for (int ilev = 0; ilev < nlevs; ++ilev)
+    {
+        MultiFab& phi = *a_phi[ilev];
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.ixType() == m_rhs[ilev].ixType() &&
+                                         phi.boxArray() == m_rhs[ilev].boxArray() &&
+                                         phi.DistributionMap() == m_rhs[ilev].DistributionMap(),
+                                         "MacProjector: phi is not cell-centered on the grids of the projector");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.nGrow() >= 1,
+                                         "MacProjector: phi needs at least one ghost cell with alias_phi");
+#ifdef AMREX_USE_EB
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.hasEBFabFactory() == m_rhs[ilev].hasEBFabFactory(),
+                                         "MacProjector: phi must be built with the EB factory of the projector");
+#endif
+        m_phi[ilev] = MultiFab(phi, amrex::make_alias, 0, 1);
+    }
+}
+
+//
+// Build the ncomp-component operator, solver and work space used by the batched
+// project, unless they already exist for this ncomp.
+//
+void
+MacProjector::setupBatch (int ncomp)
+{
+    if (m_batch_linop && m_batch_ncomp == ncomp) { return; }
+
+    BL_PROFILE("MacProjector::setupBatch");
+
+    const int nlevs = m_rhs.size();
+    Vector<BoxArray> ba(nlevs);
+    Vector<DistributionMapping> dm(nlevs);
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        ba[ilev] = m_rhs[ilev].boxArray();
+        dm[ilev] = m_rhs[ilev].DistributionMap();
+    }
+
+    m_batch_rhs.clear();
+    m_batch_phi.clear();
+    m_batch_fluxes.clear();
+    m_batch_rhs.resize(nlevs);
+    m_batch_phi.resize(nlevs);
+    m_batch_fluxes.resize(nlevs);
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        m_batch_rhs[ilev].define(ba[ilev], dm[ilev], ncomp, 0, MFInfo(), m_rhs[ilev].Factory());
+        m_batch_phi[ilev].define(ba[ilev], dm[ilev], ncomp, 1, MFInfo(), m_rhs[ilev].Factory());
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            m_batch_fluxes[ilev][idim].define(
+                amrex::convert(ba[ilev], IntVect::TheDimensionVector(idim)),
+                dm[ilev], ncomp, 0, MFInfo(), m_fluxes[ilev][idim].Factory());
+        }
+    }
+
+    // beta is copied from the single component operator, and used for every component
+#ifdef AMREX_USE_EB
+    if (m_eb_abeclap)
+    {
+        auto op = std::make_unique<MLEBABecLap>(m_geom, ba, dm, m_lpinfo, m_eb_factory, ncomp);
+        if (m_phi_loc == MLMG::Location::CellCentroid)
+            op->setPhiOnCentroid();
+        op->setDomainBC(m_lobc, m_hibc);
+        op->setScalars(0.0, 1.0);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            op->setBCoeffs(ilev, m_eb_abeclap->getBCoeffs(ilev, 0), m_beta_loc);
+        }
+        m_batch_linop = std::move(op);
+    } else
+#endif
+    {
+        auto op = std::make_unique<MLABecLaplacian>(m_geom, ba, dm, m_lpinfo,
+                                                    Vector<FabFactory<FArrayBox> const*>{}, ncomp);
+        op->setDomainBC(m_lobc, m_hibc);
+        op->setScalars(0.0, 1.0);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            op->setBCoeffs(ilev, m_abeclap->getBCoeffs(ilev, 0));
+        }
+        m_batch_linop = std::move(op);
+    }
+
+    m_batch_mlmg = std::make_unique<MLMG>(*m_batch_linop);
+    setSolverOptions(*m_batch_linop, *m_batch_mlmg);
+
+    m_batch_ncomp = ncomp;
+}
+
+ProjectionStats
+MacProjector::project (const Vector<Vector<Array<MultiFab*,AMREX_SPACEDIM> > >& a_umacs,
+                       Real reltol, Real atol)
+{
+    BL_PROFILE("MacProjector::project(batch)");
+
+    const int ncomp = a_umacs.size();
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ncomp > 0,
+                                     "MacProjector::project: no umac sets to project");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_poisson == nullptr,
+                                     "MacProjector::project: batched projection needs variable beta");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_has_overset_mask,
+                                     "MacProjector::project: batched projection does not support an overset mask");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_needs_domain_bcs,
+                                     "setDomainBC must be called before project");
+
+    const int nlevs = m_rhs.size();
+
+    setupBatch(ncomp);
+
+    // Only wait for the GPU if the timings are asked for or drive the tuner
+    const bool sync = m_timing || m_tuner.isTuning();
+
+    ProjectionStats stats;
+    Real t0 = ProjectionStats::clock(sync);
+
+    // The coarse data has to stay alive until the solve is done
+    if (m_crse_bc) {
+        m_batch_crse_bc = MultiFab(m_crse_bc->boxArray(), m_crse_bc->DistributionMap(), ncomp,
+                                   m_crse_bc->nGrow(), MFInfo(), m_crse_bc->Factory());
+        for (int n = 0; n < ncomp; ++n) {
+            MultiFab::Copy(m_batch_crse_bc, *m_crse_bc, 0, n, 1, m_crse_bc->nGrow());
+        }
+        m_batch_linop->setCoarseFineBC(&m_batch_crse_bc, m_crse_ratio);
+    }
+
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        if (m_level_bc[ilev]) {
+            MultiFab const& bc = *m_level_bc[ilev];
+            MultiFab bcn(bc.boxArray(), bc.DistributionMap(), ncomp, bc.nGrow(),
+                         MFInfo(), bc.Factory());
+            for (int n = 0; n < ncomp; ++n) {
+                MultiFab::Copy(bcn, bc, 0, n, 1, bc.nGrow());
+            }
+            m_batch_linop->setLevelBC(ilev, &bcn);
+        } else {
+            m_batch_linop->setLevelBC(ilev, nullptr);
+        }
+    }
+
+    for (auto const& umac : a_umacs) {
+        averageDownVelocity(umac);
+    }
+    Real t1 = ProjectionStats::clock(sync);
+    stats.time_average_down += t1 - t0;
+    t0 = t1;
+
+    BL_PROFILE_VAR("MacProjector::project(batch)::rhs", mac_rhs);
+
+    for (int n = 0; n < ncomp; ++n) {
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            MultiFab rhs(m_batch_rhs[ilev], amrex::make_alias, n, 1);
+            MultiFab phi(m_batch_phi[ilev], amrex::make_alias, n, 1);
+            assembleRHS(ilev, a_umacs[n][ilev], rhs, phi, true, stats);
+        }
+    }
+
+    Real reltol_used = reltol;
+    if (!m_tol_control.isFixed())
+    {
+        Real rhs_norm = 0.0;
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            for (int n = 0; n < ncomp; ++n) {
+                rhs_norm = amrex::max(rhs_norm, m_batch_rhs[ilev].norm0(n, 0, true));
+            }
+        }
+        ParallelDescriptor::ReduceRealMax(rhs_norm);
+
+        reltol_used = m_tol_control.chooseReltol(reltol, rhs_norm);
+        if (m_verbose > 0) {
+            amrex::Print() << "MacProjector: using reltol = " << reltol_used << std::endl;
+        }
+    }
+    stats.reltol = reltol_used;
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_rhs = t1 - t0;
+    t0 = t1;
+
+    BL_PROFILE_VAR_STOP(mac_rhs);
+    BL_PROFILE_VAR("MacProjector::project(batch)::solve", mac_solve);
+
+    m_batch_mlmg->solve(amrex::GetVecOfPtrs(m_batch_phi), amrex::GetVecOfConstPtrs(m_batch_rhs),
+                        reltol_used, atol);
+
+    BL_PROFILE_VAR_STOP(mac_solve);
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_solve        = t1 - t0;
+    stats.num_solves        = 1;
+    stats.iterations        = m_batch_mlmg->getNumIters();
+    stats.bottom_iterations = m_batch_mlmg->getNumCGIters();
+    stats.initial_residual  = m_batch_mlmg->getInitResidual();
+    stats.final_residual    = m_batch_mlmg->getFinalResidual();
+    t0 = t1;
+
+    BL_PROFILE_VAR("MacProjector::project(batch)::fluxes", mac_fluxes);
+
+    m_batch_mlmg->getFluxes(amrex::GetVecOfArrOfPtrs(m_batch_fluxes), m_umac_loc);
+
+    for (int n = 0; n < ncomp; ++n) {
+        correctVelocity(a_umacs[n], m_batch_fluxes, n);
+    }
+
+    BL_PROFILE_VAR_STOP(mac_fluxes);
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_fluxes = t1 - t0;
+    t0 = t1;
+
+    for (auto const& umac : a_umacs) {
+        averageDownVelocity(umac);
+    }
+
+    stats.time_average_down += ProjectionStats::clock(sync) - t0;
+
+    return stats;
 }
 
 void
 MacProjector::getFluxes (const Vector<Array<MultiFab*,AMREX_SPACEDIM> >& a_flux,
                          const Vector<MultiFab*>& a_sol, MLMG::Location a_loc) const
 {
+    BL_PROFILE("MacProjector::getFluxes");
+
     int ilev = 0;
     if (m_needs_level_bcs[ilev])
         m_linop->setLevelBC(ilev, nullptr);
@@ -334,11 +784,110 @@ MacProjector::getFluxes (const Vector<Array<MultiFab*,AMREX_SPACEDIM> >& a_flux,
     }
 }
 
+//
+// Build the single precision operator and MLMG used by top_solver = refine,
+// unless they already exist. The operator is a float copy of m_linop with
+// homogeneous BCs, as it only solves for corrections. Not available with EB,
+// where the float operator does not exist, or with an overset mask, which is
+// not kept.
+//
+void
+MacProjector::setupRefine ()
+{
+    if (m_refine_mlmg) { return; }
+
+    BL_PROFILE("MacProjector::setupRefine");
+
+#ifdef AMREX_USE_EB
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_eb_abeclap,
+                                     "MacProjector: mac_proj.top_solver = refine is not available with EB");
+#endif
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_has_overset_mask,
+                                     "MacProjector: mac_proj.top_solver = refine is not available with an overset mask");
+
+    const int nlevs = m_rhs.size();
+    Vector<BoxArray> ba(nlevs);
+    Vector<DistributionMapping> dm(nlevs);
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        ba[ilev] = m_rhs[ilev].boxArray();
+        dm[ilev] = m_rhs[ilev].DistributionMap();
+    }
+
+    if (m_abeclap)
+    {
+        auto op = std::make_unique<MLABecLaplacianT<fMultiFab> >(m_geom, ba, dm, m_lpinfo);
+        op->setDomainBC(m_lobc, m_hibc);
+        op->setScalars(0.0f, 1.0f);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            auto const& beta = m_abeclap->getBCoeffs(ilev, 0);
+            Array<fMultiFab,AMREX_SPACEDIM> fbeta;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                fbeta[idim].define(beta[idim]->boxArray(), beta[idim]->DistributionMap(), 1, 0);
+                fbeta[idim].LocalCopy(*beta[idim], 0, 0, 1, IntVect(0));
+            }
+            op->setBCoeffs(ilev, GetArrOfConstPtrs(fbeta));
+        }
+        m_refine_linop = std::move(op);
+    }
+    else
+    {
+        auto op = std::make_unique<MLPoissonT<fMultiFab> >(m_geom, ba, dm, m_lpinfo);
+        op->setDomainBC(m_lobc, m_hibc);
+        m_refine_linop = std::move(op);
+    }
+
+    // Homogeneous BCs: zero coarse data and zero boundary values
+    if (m_crse_bc) {
+        m_refine_linop->setCoarseFineBC(nullptr, m_crse_ratio);
+    }
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        m_refine_linop->setLevelBC(ilev, nullptr);
+    }
+
+    int maxorder(3);
+    int num_pre_smooth(2);
+    int num_post_smooth(2);
+
+    ParmParse pp("mac_proj");
+    pp.query( "maxorder"        , maxorder );
+    pp.query( "num_pre_smooth"  , num_pre_smooth );
+    pp.query( "num_post_smooth" , num_post_smooth );
+
+    // The bottom solver is left at the MLMG default, bicgstab, which the
+    // other bottom solvers may not support in single precision
+    m_refine_linop->setMaxOrder(maxorder);
+    m_refine_mlmg = std::make_unique<MLMGT<fMultiFab> >(*m_refine_linop);
+    m_refine_mlmg->setPreSmooth(num_pre_smooth);
+    m_refine_mlmg->setPostSmooth(num_post_smooth);
+}
+
 //
 // Set options by using default values and values read in input file
 //
 void
 MacProjector::setOptions ()
+{
+    setSolverOptions(*m_linop, *m_mlmg);
+
+    m_tol_control.readParameters("mac_proj");
+    m_top_solver.readParameters("mac_proj");
+#ifdef AMREX_USE_EB
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_eb_abeclap || m_top_solver.type() != ProjectionKrylov::Type::Refine,
+                                     "MacProjector: mac_proj.top_solver = refine is not available with EB");
+#endif
+    m_tuner.readParameters("mac_proj", "bicg");
+
+    int alias_phi(m_alias_phi);
+    int timing(m_timing);
+    ParmParse pp("mac_proj");
+    pp.query( "alias_phi" , alias_phi );
+    pp.query( "timing"    , timing );
+    m_alias_phi = (alias_phi != 0);
+    m_timing    = (timing != 0);
+}
+
+void
+MacProjector::setSolverOptions (MLLinOp& linop, MLMG& mlmg)
 {
     // Default values
     int          maxorder(3);
@@ -367,51 +916,227 @@ MacProjector::setOptions ()
     pp.query( "num_post_smooth" , num_post_smooth );
 
     // Set default/input values
-    m_linop->setMaxOrder(maxorder);
-    m_mlmg->setVerbose(m_verbose);
-    m_mlmg->setBottomVerbose(bottom_verbose);
-    m_mlmg->setMaxIter(maxiter);
-    m_mlmg->setBottomMaxIter(bottom_maxiter);
-    m_mlmg->setBottomTolerance(bottom_rtol);
-    m_mlmg->setBottomToleranceAbs(bottom_atol);
+    linop.setMaxOrder(maxorder);
+    mlmg.setVerbose(m_verbose);
+    mlmg.setBottomVerbose(bottom_verbose);
+    mlmg.setMaxIter(maxiter);
+    mlmg.setBottomMaxIter(bottom_maxiter);
+    mlmg.setBottomTolerance(bottom_rtol);
+    mlmg.setBottomToleranceAbs(bottom_atol);
 
-    m_mlmg->setPreSmooth(num_pre_smooth);
-    m_mlmg->setPostSmooth(num_post_smooth);
+    mlmg.setPreSmooth(num_pre_smooth);
+    mlmg.setPostSmooth(num_post_smooth);
 
     if (bottom_solver == "smoother")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::smoother);
+        mlmg.setBottomSolver(MLMG::BottomSolver::smoother);
     }
     else if (bottom_solver == "bicg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::bicgstab);
+        mlmg.setBottomSolver(MLMG::BottomSolver::bicgstab);
     }
     else if (bottom_solver == "cg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::cg);
+        mlmg.setBottomSolver(MLMG::BottomSolver::cg);
     }
     else if (bottom_solver == "bicgcg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::bicgcg);
+        mlmg.setBottomSolver(MLMG::BottomSolver::bicgcg);
     }
     else if (bottom_solver == "cgbicg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::cgbicg);
+        mlmg.setBottomSolver(MLMG::BottomSolver::cgbicg);
     }
     else if (bottom_solver == "hypre")
     {
 #ifdef AMREX_USE_HYPRE
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::hypre);
+        mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
 #else
         amrex::Abort("AMReX was not built with HYPRE support");
 #endif
     }
+
+    // Settings picked by the autotuner take precedence
+    m_tuner.applyTo(mlmg);
 }
 
+//
+// Start the autotuner on the current grids if needed, and use the settings it
+// wants tried next. A change of coarsening rebuilds the operator.
+//
 void
-MacProjector::averageDownVelocity ()
+MacProjector::applyTuner ()
 {
-    int finest_level = m_umac.size() - 1;
+    if (!m_tuner.isStarted())
+    {
+        const int nlevs = m_rhs.size();
+        Vector<BoxArray> ba(nlevs);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            ba[ilev] = m_rhs[ilev].boxArray();
+        }
+        m_tuner.start(ProjectionTuner::gridSignature("mac_proj", m_geom, ba),
+                      m_lpinfo, !m_has_overset_mask);
+    }
+
+    const LPInfo lpinfo = m_tuner.lpinfo(m_lpinfo);
+    if (!ProjectionTuner::sameCoarsening(lpinfo, m_lpinfo)) {
+        rebuildOperator(lpinfo);
+    }
+
+    m_tuner.applyTo(*m_mlmg);
+    if (m_precond_mlmg) {
+        m_tuner.applyTo(*m_precond_mlmg);
+    }
+}
+
+//
+// Replace the operator and MLMG with ones built with a_lpinfo. beta and the
+// BCs are carried over from the current operator. Not available with an
+// overset mask, which is not kept.
+//
+void
+MacProjector::rebuildOperator (const LPInfo& a_lpinfo)
+{
+    BL_PROFILE("MacProjector::rebuildOperator");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_has_overset_mask,
+                                     "MacProjector::rebuildOperator: not supported with an overset mask");
+
+    const int nlevs = m_rhs.size();
+    Vector<BoxArray> ba(nlevs);
+    Vector<DistributionMapping> dm(nlevs);
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        ba[ilev] = m_rhs[ilev].boxArray();
+        dm[ilev] = m_rhs[ilev].DistributionMap();
+    }
+
+#ifdef AMREX_USE_EB
+    if (m_eb_abeclap)
+    {
+        auto op = std::make_unique<MLEBABecLap>(m_geom, ba, dm, a_lpinfo, m_eb_factory);
+        if (m_phi_loc == MLMG::Location::CellCentroid)
+            op->setPhiOnCentroid();
+        op->setScalars(0.0, 1.0);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            op->setBCoeffs(ilev, m_eb_abeclap->getBCoeffs(ilev, 0), m_beta_loc);
+        }
+        m_eb_abeclap = std::move(op);
+        m_linop = m_eb_abeclap.get();
+    } else
+#endif
+    if (m_abeclap)
+    {
+        auto op = std::make_unique<MLABecLaplacian>(m_geom, ba, dm, a_lpinfo);
+        op->setScalars(0.0, 1.0);
+        for (int ilev = 0; ilev < nlevs; ++ilev) {
+            op->setBCoeffs(ilev, m_abeclap->getBCoeffs(ilev, 0));
+        }
+        m_abeclap = std::move(op);
+        m_linop = m_abeclap.get();
+    }
+    else
+    {
+        m_poisson = std::make_unique<MLPoisson>(m_geom, ba, dm, a_lpinfo);
+        m_linop = m_poisson.get();
+    }
+
+    if (!m_needs_domain_bcs) {
+        m_linop->setDomainBC(m_lobc, m_hibc);
+    }
+    if (m_crse_bc) {
+        m_linop->setCoarseFineBC(m_crse_bc, m_crse_ratio);
+    }
+    for (int ilev = 0; ilev < nlevs; ++ilev) {
+        if (!m_needs_level_bcs[ilev]) {
+            m_linop->setLevelBC(ilev, m_level_bc[ilev]);
+        }
+    }
+
+    m_lpinfo = a_lpinfo;
+    m_batch_ncomp = 0;
+
+    m_mlmg = std::make_unique<MLMG>(*m_linop);
+    setSolverOptions(*m_linop, *m_mlmg);
+    m_precond_mlmg.reset();
+    m_refine_mlmg.reset();
+}
+
+//
+// umac = umac + fac * flux(fcomp), with fac = const_beta for MLPoisson and 1 otherwise,
+// and umac = 0 on covered faces. This is done in a single pass over each face
+// MultiFab rather than a Saxpy/Add followed by EB_set_covered_faces.
+//
+void
+MacProjector::correctVelocity (const Vector<Array<MultiFab*,AMREX_SPACEDIM> >& a_umac,
+                               const Vector<Array<MultiFab,AMREX_SPACEDIM> >& a_fluxes,
+                               int fcomp)
+{
+    BL_PROFILE("MacProjector::correctVelocity");
+
+    const int nlevs = a_umac.size();
+    const Real fac = m_poisson ? m_const_beta : Real(1.0);
+
+    for (int ilev = 0; ilev < nlevs; ++ilev)
+    {
+#ifdef AMREX_USE_EB
+        // A projector built without EB factory takes the plain update below
+        const bool has_eb = !m_eb_factory.empty() && m_eb_factory[ilev] != nullptr;
+        FabArray<EBCellFlagFab> const* flags = has_eb ? &(m_eb_factory[ilev]->getMultiEBCellFlagFab())
+                                                      : nullptr;
+#endif
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            MultiFab&       umac = *a_umac[ilev][idim];
+            MultiFab const& flux = a_fluxes[ilev][idim];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(umac, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                Box const& bx = mfi.tilebox();
+                Array4<Real>       const& u = umac.array(mfi);
+                Array4<Real const> const& f = flux.const_array(mfi, fcomp);
+
+#ifdef AMREX_USE_EB
+                // Cells on either side of the faces in bx
+                const Box cbx = amrex::grow(amrex::enclosedCells(bx), idim, 1);
+                const auto fabtyp = has_eb ? (*flags)[mfi].getType(cbx) : FabType::regular;
+
+                if (fabtyp == FabType::covered)
+                {
+                    amrex::ParallelFor(bx, [u] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        u(i,j,k) = 0.0;
+                    });
+                }
+                else if (fabtyp != FabType::regular)
+                {
+                    Array4<Real const> const& ap = m_eb_factory[ilev]->getAreaFrac()[idim]->const_array(mfi);
+                    amrex::ParallelFor(bx, [u,f,ap,fac] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        u(i,j,k) = (ap(i,j,k) == 0.0) ? Real(0.0) : u(i,j,k) + fac*f(i,j,k);
+                    });
+                }
+                else
+#endif
+                {
+                    amrex::ParallelFor(bx, [u,f,fac] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                    {
+                        u(i,j,k) += fac*f(i,j,k);
+                    });
+                }
+            }
+        }
+    }
+}
+
+void
+MacProjector::averageDownVelocity (const Vector<Array<MultiFab*,AMREX_SPACEDIM> >& a_umac)
+{
+    BL_PROFILE("MacProjector::averageDownVelocity");
+
+    int finest_level = a_umac.size() - 1;
 
 
     for (int lev = finest_level; lev > 0; --lev)
@@ -420,12 +1145,12 @@ MacProjector::averageDownVelocity ()
         IntVect rr  = m_geom[lev].Domain().size() / m_geom[lev-1].Domain().size();
 
 #ifdef AMREX_USE_EB
-        EB_average_down_faces(GetArrOfConstPtrs(m_umac[lev]),
-                              m_umac[lev-1],
+        EB_average_down_faces(GetArrOfConstPtrs(a_umac[lev]),
+                              a_umac[lev-1],
                               rr, m_geom[lev-1]);
 #else
-        average_down_faces(GetArrOfConstPtrs(m_umac[lev]),
-                           m_umac[lev-1],
+        average_down_faces(GetArrOfConstPtrs(a_umac[lev]),
+                           a_umac[lev-1],
                            rr, m_geom[lev-1]);
 #endif
     }
@@ -447,15 +1172,18 @@ void MacProjector::initProjector (Vector<BoxArray> const& a_grids,
     auto const& dm = a_dmap;
 
     m_rhs.resize(nlevs);
-    m_phi.resize(nlevs);
     m_fluxes.resize(nlevs);
     m_divu.resize(nlevs);
 
+    m_lpinfo = a_lpinfo;
+    m_has_overset_mask = !a_overset_mask.empty();
+    m_level_bc.clear();
+    m_level_bc.resize(nlevs, nullptr);
+    m_batch_ncomp = 0;
+
     for (int ilev = 0; ilev < nlevs; ++ilev) {
         m_rhs[ilev].define(ba[ilev], dm[ilev], 1, 0);
-        m_phi[ilev].define(ba[ilev], dm[ilev], 1, 1);
         m_rhs[ilev].setVal(0.0);
-        m_phi[ilev].setVal(0.0);
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             m_fluxes[ilev][idim].define(
                 amrex::convert(ba[ilev], IntVect::TheDimensionVector(idim)),
@@ -472,8 +1200,11 @@ void MacProjector::initProjector (Vector<BoxArray> const& a_grids,
     m_linop = m_poisson.get();
 
     m_mlmg = std::make_unique<MLMG>(*m_linop);
+    m_precond_mlmg.reset();
+    m_refine_mlmg.reset();
 
     setOptions();
+    definePhi();
 
     m_needs_init = false;
 }
@@ -57,7 +57,6 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
     }
 
     // Resize member data
-    m_phi.resize(nlevs);
     m_fluxes.resize(nlevs);
     m_rhs.resize(nlevs);
 
@@ -67,9 +66,11 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
     if (has_eb)
     {
         m_ebfactory.resize(nlevs,nullptr);
+        m_ebfactory_clone.resize(nlevs);
         for (int lev = 0; lev < nlevs; ++lev )
         {
-            m_ebfactory[lev] = dynamic_cast<EBFArrayBoxFactory const*>(&(m_vel[lev]->Factory()));
+            m_ebfactory_clone[lev].reset(m_vel[lev]->Factory().clone());
+            m_ebfactory[lev] = dynamic_cast<EBFArrayBoxFactory const*>(m_ebfactory_clone[lev].get());
 
             // Cell-centered data
             m_fluxes[lev].define(ba[lev], dm[lev], AMREX_SPACEDIM, 0, MFInfo(), m_vel[lev]->Factory());
@@ -77,7 +78,6 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
             // Node-centered data
             auto tmp = ba[lev];
             const auto& ba_nd = tmp.surroundingNodes();
-            m_phi[lev].define(ba_nd, dm[lev], 1, 1, MFInfo(), m_vel[lev]->Factory());
             m_rhs[lev].define(ba_nd, dm[lev], 1, 0, MFInfo(), m_vel[lev]->Factory());
         }
     }
@@ -92,19 +92,97 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
             // Node-centered data
             BoxArray tmp = ba[lev];
             const auto& ba_nd = tmp.surroundingNodes();
-            m_phi[lev].define(ba_nd, dm[lev], 1, 1);
             m_rhs[lev].define(ba_nd, dm[lev], 1, 0);
         }
     }
 
     // Initialize all variables
-    for (int lev(0); lev < m_phi.size(); ++lev)
+    for (int lev(0); lev < nlevs; ++lev)
     {
-        m_phi[lev].setVal(0.0);
         m_fluxes[lev].setVal(0.0);
         m_rhs[lev].setVal(0.0);
     }
 
+    defineOperator(a_lpinfo);
+
+    setOptions();
+
+    definePhi();
+}
+
+
+//
+// Allocate phi, unless the projector solves into the phi passed to project
+//
+void
+NodalProjector::definePhi ()
+{
+    int nlevs = m_rhs.size();
+    m_phi.clear();
+    m_phi.resize(nlevs);
+
+    if (m_alias_phi) { return; }
+
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        m_phi[lev].define(m_rhs[lev].boxArray(), m_rhs[lev].DistributionMap(), 1, 1,
+                          MFInfo(), m_rhs[lev].Factory());
+        m_phi[lev].setVal(0.0);
+    }
+}
+
+void
+NodalProjector::setAliasPhi (bool a_alias)
+{
+    if (a_alias == m_alias_phi) { return; }
+    m_alias_phi = a_alias;
+    definePhi();
+}
+
+//
+// Make m_phi an alias of the first component of a_phi, after checking that a_phi
+// can be solved into directly
+//
+void
+NodalProjector::bindPhi (const Vector<MultiFab*>& a_phi)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_phi.size() == m_rhs.size(),
+                                     "NodalProjector: a_phi must have one MultiFab per level");
+
+    for (int lev(0); lev < m_rhs.size(); ++lev)
+    {
+        MultiFab& phi = *a_phi[lev];
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.ixType().nodeCentered() &&
+                                         phi.boxArray() == m_rhs[lev].boxArray() &&
+                                         phi.DistributionMap() == m_rhs[lev].DistributionMap(),
+                                         "NodalProjector: a_phi is not nodal on the grids of the projector");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.nGrow() >= 1,
+                                         "NodalProjector: a_phi needs at least one ghost node with alias_phi");
+#ifdef AMREX_USE_EB
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(phi.hasEBFabFactory() == m_rhs[lev].hasEBFabFactory(),
+                                         "NodalProjector: a_phi must be built with the EB factory of the projector");
+#endif
+        m_phi[lev] = MultiFab(phi, amrex::make_alias, 0, 1);
+    }
+}
+
+
+//
+// Build the linear operator and MLMG on the grids of m_vel
+//
+void
+NodalProjector::defineOperator (LPInfo const& a_lpinfo)
+{
+    int nlevs = m_vel.size();
+
+    Vector<BoxArray> ba(nlevs);
+    Vector<DistributionMapping> dm(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        ba[lev] = m_vel[lev]->boxArray();
+        dm[lev] = m_vel[lev]->DistributionMap();
+    }
+
     //
     // Setup linear operator
     //
@@ -128,12 +206,56 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
     m_linop->setGaussSeidel(true);
     m_linop->setHarmonicAverage(false);
 
+    Real normalization_threshold(-1.);
+
+    ParmParse pp("nodal_proj");
+    pp.query( "normalization_threshold" , normalization_threshold);
+
+    // This is only used by the Krylov solvers but we pass it through the nodal operator
+    //      if it is set here.  Otherwise we use the default set in AMReX_NodeLaplacian.H
+    if (normalization_threshold > 0.)
+        m_linop->setNormalizationThreshold(normalization_threshold);
+
     //
     // Setup solver
     //
     m_mlmg = std::make_unique<MLMG>(*m_linop);
+    m_precond_mlmg.reset();
 
-    setOptions();
+    m_lpinfo = a_lpinfo;
+}
+
+
+//
+// Start the autotuner on the current grids if needed, and use the settings it
+// wants tried next. A change of coarsening rebuilds the operator, keeping phi.
+//
+void
+NodalProjector::applyTuner ()
+{
+    if (!m_tuner.isStarted())
+    {
+        Vector<BoxArray> ba(m_vel.size());
+        for (int lev = 0; lev < m_vel.size(); ++lev) {
+            ba[lev] = m_vel[lev]->boxArray();
+        }
+        m_tuner.start(ProjectionTuner::gridSignature("nodal_proj", m_geom, ba), m_lpinfo, true);
+    }
+
+    const LPInfo lpinfo = m_tuner.lpinfo(m_lpinfo);
+    if (!ProjectionTuner::sameCoarsening(lpinfo, m_lpinfo))
+    {
+        defineOperator(lpinfo);
+        setSolverOptions(*m_mlmg);
+        if (!m_need_bcs) {
+            m_linop->setDomainBC(m_bc_lo, m_bc_hi);
+        }
+    }
+
+    m_tuner.applyTo(*m_mlmg);
+    if (m_precond_mlmg) {
+        m_tuner.applyTo(*m_precond_mlmg);
+    }
 }
 
 
@@ -142,6 +264,44 @@ void NodalProjector::define (LPInfo const& a_lpinfo)
 //
 void
 NodalProjector::setOptions ()
+{
+    setSolverOptions(*m_mlmg);
+
+    m_tol_control.readParameters("nodal_proj");
+    m_top_solver.readParameters("nodal_proj");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_top_solver.type() != ProjectionKrylov::Type::Refine,
+                                     "NodalProjector: nodal_proj.top_solver = refine is not available, "
+                                     "there is no single precision nodal operator");
+    m_tuner.readParameters("nodal_proj", "bicgcg");
+
+    int  inexact_vcycles(0);
+    int  inexact_carry(1);
+    int  alias_phi(m_alias_phi);
+    int  timing(m_timing);
+
+    ParmParse pp("nodal_proj");
+    pp.query( "inexact_vcycles" , inexact_vcycles );
+    pp.query( "inexact_carry"   , inexact_carry );
+    pp.query( "alias_phi"       , alias_phi );
+    pp.query( "timing"          , timing );
+
+    setInexact(inexact_vcycles, inexact_carry != 0);
+    m_alias_phi = (alias_phi != 0);
+    m_timing    = (timing != 0);
+}
+
+void
+NodalProjector::setInexact (int a_vcycles, bool a_carry)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_vcycles >= 0,
+                                     "NodalProjector::setInexact: a_vcycles must not be negative");
+
+    m_inexact_vcycles = a_vcycles;
+    m_inexact_carry   = a_carry;
+}
+
+void
+NodalProjector::setSolverOptions (MLMG& a_mlmg)
 {
     // Default values
     int          bottom_verbose(0);
@@ -154,8 +314,6 @@ NodalProjector::setOptions ()
     int          num_pre_smooth (2);
     int          num_post_smooth(2);
 
-    Real         normalization_threshold(-1.);
-
     // Read from input file
     ParmParse pp("nodal_proj");
     pp.query( "verbose"       , m_verbose );
@@ -166,53 +324,49 @@ NodalProjector::setOptions ()
     pp.query( "bottom_atol"   , bottom_atol );
     pp.query( "bottom_solver" , bottom_solver );
 
-    pp.query( "normalization_threshold" , normalization_threshold);
-
     pp.query( "num_pre_smooth"  , num_pre_smooth );
     pp.query( "num_post_smooth" , num_post_smooth );
 
-    // This is only used by the Krylov solvers but we pass it through the nodal operator
-    //      if it is set here.  Otherwise we use the default set in AMReX_NodeLaplacian.H
-    if (normalization_threshold > 0.)
-        m_linop->setNormalizationThreshold(normalization_threshold);
-
     // Set default/input values
-    m_mlmg->setVerbose(m_verbose);
-    m_mlmg->setBottomVerbose(bottom_verbose);
-    m_mlmg->setMaxIter(maxiter);
-    m_mlmg->setBottomMaxIter(bottom_maxiter);
-    m_mlmg->setBottomTolerance(bottom_rtol);
-    m_mlmg->setBottomToleranceAbs(bottom_atol);
+    a_mlmg.setVerbose(m_verbose);
+    a_mlmg.setBottomVerbose(bottom_verbose);
+    a_mlmg.setMaxIter(maxiter);
+    a_mlmg.setBottomMaxIter(bottom_maxiter);
+    a_mlmg.setBottomTolerance(bottom_rtol);
+    a_mlmg.setBottomToleranceAbs(bottom_atol);
 
-    m_mlmg->setPreSmooth(num_pre_smooth);
-    m_mlmg->setPostSmooth(num_post_smooth);
+    a_mlmg.setPreSmooth(num_pre_smooth);
+    a_mlmg.setPostSmooth(num_post_smooth);
 
     if (bottom_solver == "smoother")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::smoother);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::smoother);
     }
     else if (bottom_solver == "bicg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::bicgstab);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::bicgstab);
     }
     else if (bottom_solver == "cg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::cg);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::cg);
     }
     else if (bottom_solver == "bicgcg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::bicgcg);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::bicgcg);
     }
     else if (bottom_solver == "cgbicg")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::cgbicg);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::cgbicg);
     }
 #ifdef AMREX_USE_HYPRE
     else if (bottom_solver == "hypre")
     {
-        m_mlmg->setBottomSolver(MLMG::BottomSolver::hypre);
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
     }
 #endif
+
+    // Settings picked by the autotuner take precedence
+    m_tuner.applyTo(a_mlmg);
 }
 
 void
@@ -240,10 +394,53 @@ NodalProjector::setCustomRHS (const amrex::Vector<const amrex::MultiFab*> a_rhs)
 
 
 void
+NodalProjector::reset ( const Vector<MultiFab*>&       a_vel,
+                        const Vector<const MultiFab*>& a_sigma,
+                        const Vector<MultiFab*>&       a_S_cc,
+                        const Vector<const MultiFab*>& a_S_nd )
+{
+    AMREX_ALWAYS_ASSERT(a_vel.size()==m_vel.size());
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_sigma.empty() == m_sigma.empty(),
+                                     "NodalProjector::reset: cannot switch between constant and variable sigma");
+
+    for (int lev(0); lev < m_vel.size(); ++lev)
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_vel[lev]->boxArray() == m_vel[lev]->boxArray() &&
+                                         a_vel[lev]->DistributionMap() == m_vel[lev]->DistributionMap(),
+                                         "NodalProjector::reset: a_vel is not on the grids of the projector");
+    }
+
+    m_vel   = a_vel;
+    m_sigma = a_sigma;
+    m_S_cc  = a_S_cc;
+    m_S_nd  = a_S_nd;
+
+    m_alpha.clear();
+    m_has_alpha = false;
+    m_has_rhs   = false;
+
+    m_sync_resid_crse = nullptr;
+    m_sync_resid_fine = nullptr;
+}
+
+
+ProjectionStats
 NodalProjector::project ( Real a_rtol, Real a_atol )
 {
     BL_PROFILE("NodalProjector::project");
     AMREX_ALWAYS_ASSERT(!m_need_bcs);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_phi[0].isDefined(),
+                                     "NodalProjector: with alias_phi, phi must be passed to project");
+
+    if (m_tuner.isEnabled()) {
+        applyTuner();
+    }
+
+    // Only wait for the GPU if the timings are asked for or drive the tuner
+    const bool sync = m_timing || m_tuner.isTuning();
+
+    ProjectionStats stats;
+    Real t0 = ProjectionStats::clock(sync);
 
     if (m_verbose > 0)
         amrex::Print() << "Nodal Projection:" << std::endl;
@@ -258,6 +455,10 @@ NodalProjector::project ( Real a_rtol, Real a_atol )
     //
     averageDown(m_vel);
 
+    Real t1 = ProjectionStats::clock(sync);
+    stats.time_average_down = t1 - t0;
+    t0 = t1;
+
     // Set matrix coefficients
     for (int lev = 0; lev < m_sigma.size(); ++lev)
     {
@@ -270,6 +471,39 @@ NodalProjector::project ( Real a_rtol, Real a_atol )
         computeRHS( GetVecOfPtrs(m_rhs), m_vel, m_S_cc, m_S_nd );
     }
 
+    // Add the divergence left behind by the previous, inexact, projection. A RHS
+    // computed from the velocity already sees it, so only a custom RHS gets it.
+    if (m_has_carry)
+    {
+        if (m_has_rhs)
+        {
+            for (int lev(0); lev < m_rhs.size(); ++lev)
+            {
+                MultiFab::Add(m_rhs[lev], m_carry[lev], 0, 0, 1, 0);
+            }
+        }
+        m_has_carry = false;
+    }
+
+    Real rtol_used = a_rtol;
+    if (!m_tol_control.isFixed())
+    {
+        Real rhs_norm = 0.0;
+        for (int lev(0); lev < m_rhs.size(); ++lev)
+        {
+            rhs_norm = amrex::max(rhs_norm, m_rhs[lev].norm0(0,0,true,true));
+        }
+        ParallelDescriptor::ReduceRealMax(rhs_norm);
+
+        rtol_used = m_tol_control.chooseReltol(a_rtol, rhs_norm);
+        if (m_verbose > 0)
+            amrex::Print() << " >> Using rtol = " << rtol_used << std::endl;
+    }
+    stats.reltol = rtol_used;
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_rhs = t1 - t0;
+
     // Print diagnostics
     if (m_verbose > 0)
     {
@@ -280,42 +514,99 @@ NodalProjector::project ( Real a_rtol, Real a_atol )
 
     // Solve
     // phi comes out already averaged-down and ready to be used by caller if needed
-    m_mlmg -> solve( GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs), a_rtol, a_atol );
+    t0 = ProjectionStats::clock(sync);
+    ProjectionStats top_stats;
+    const bool inexact = (m_inexact_vcycles > 0);
+    const bool use_top_solver = !inexact && m_top_solver.isActive(m_phi.size());
+    if (use_top_solver)
+    {
+        if (!m_precond_mlmg) {
+            m_precond_mlmg = std::make_unique<MLMG>(*m_linop);
+            setSolverOptions(*m_precond_mlmg);
+        }
+        top_stats = m_top_solver.solve(*m_linop, *m_precond_mlmg, m_phi[0], m_rhs[0],
+                                       rtol_used, a_atol, m_verbose);
+    }
 
-    // Get fluxes -- fluxes = - sigma * grad(phi)
-    m_mlmg -> getFluxes( GetVecOfPtrs(m_fluxes) );
+    if (inexact) {
+        m_mlmg->setFixedIter(m_inexact_vcycles);
+    }
 
-    // Compute sync residual BEFORE performing projection
-    computeSyncResidual();
+    // After a Krylov solve this normally takes no iterations, but it checks the
+    // solution and leaves MLMG ready for getFluxes
+    m_mlmg -> solve( GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs), rtol_used, a_atol );
 
-    // Perform projection
-    for (int lev(0); lev < m_phi.size(); ++lev)
+    // Leave m_mlmg converging, for getMLMG and for whoever turns the inexact mode off
+    if (inexact) {
+        m_mlmg->setFixedIter(0);
+    }
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_solve        = t1 - t0;
+    stats.num_solves        = 1;
+    stats.iterations        = top_stats.iterations + m_mlmg->getNumIters();
+    stats.bottom_iterations = m_mlmg->getNumCGIters();
+    stats.krylov_iterations = top_stats.krylov_iterations;
+    stats.initial_residual  = use_top_solver ? top_stats.initial_residual
+                                             : m_mlmg->getInitResidual();
+    stats.final_residual    = m_mlmg->getFinalResidual();
+    m_tuner.record(stats, m_verbose);
+    t0 = t1;
+
+    // Keep what the inexact solve left behind for the next projection
+    if (inexact && m_inexact_carry && m_has_rhs)
     {
-        if (m_has_alpha)
+        if (m_carry.size() != m_rhs.size())
         {
-            // fluxes -> fluxes/alpha = - ( sigma / alpha ) * grad(phi)
-            for (int n = 0; n < AMREX_SPACEDIM; ++n)
+            m_carry.resize(m_rhs.size());
+            for (int lev(0); lev < m_rhs.size(); ++lev)
             {
-                MultiFab::Divide( m_fluxes[lev], *m_alpha[lev], 0, n, 1, 0 );
+                m_carry[lev].define(m_rhs[lev].boxArray(), m_rhs[lev].DistributionMap(), 1, 0,
+                                    MFInfo(), m_rhs[lev].Factory());
             }
         }
 
-        //
-        // vel = vel + fluxes = vel - ( sigma / alpha ) * grad(phi)
-        //
-        MultiFab::Add( *m_vel[lev], m_fluxes[lev], 0, 0, AMREX_SPACEDIM, 0);
+        m_mlmg->compResidual( GetVecOfPtrs(m_carry), GetVecOfPtrs(m_phi), GetVecOfConstPtrs(m_rhs) );
+        m_has_carry = true;
+
+        for (int lev(0); lev < m_carry.size(); ++lev)
+        {
+            stats.carried_residual = amrex::max(stats.carried_residual,
+                                                m_carry[lev].norm0(0,0,false,true));
+        }
+
+        if (m_verbose > 0)
+            amrex::Print() << " >> Carrying residual " << stats.carried_residual
+                           << " to the next projection" << std::endl;
+    }
+
+    t1 = ProjectionStats::clock(sync);
+    stats.time_solve += t1 - t0;
+    t0 = t1;
+
+    // Compute sync residual BEFORE performing projection
+    computeSyncResidual();
 
-        // set m_fluxes = grad(phi)
-        m_linop->compGrad(lev,m_fluxes[lev],m_phi[lev]);
+    // Perform projection: vel = vel - ( sigma / alpha ) * grad(phi), and
+    // set m_fluxes = grad(phi)
+    for (int lev(0); lev < m_phi.size(); ++lev)
+    {
+        correctVelocity(lev);
     }
 
     //
     // At this time, results are "correct" only on regions not covered by finer grids.
     // We average them down so that they are "correct" everywhere in each level.
     //
+    t1 = ProjectionStats::clock(sync);
+    stats.time_fluxes = t1 - t0;
+    t0 = t1;
+
     averageDown(GetVecOfPtrs(m_fluxes));
     averageDown(m_vel);
 
+    stats.time_average_down += ProjectionStats::clock(sync) - t0;
+
 
     // Print diagnostics
     if ( (m_verbose > 0) && (!m_has_rhs))
@@ -326,24 +617,142 @@ NodalProjector::project ( Real a_rtol, Real a_atol )
         amrex::Print() << std::endl;
     }
 
+    return stats;
 }
 
+//
+// Compute grad(phi) into m_fluxes and subtract ( sigma / alpha ) * grad(phi)
+// from the velocity. Where the level is all regular, this is done in a single
+// pass over phi, sigma, alpha and vel. Otherwise grad(phi) comes from the
+// linear operator, which accounts for the cut cells, and covered cells are
+// left untouched.
+//
 void
+NodalProjector::correctVelocity (int a_lev)
+{
+    BL_PROFILE("NodalProjector::correctVelocity");
+
+    bool fused_grad = true;
+#ifdef AMREX_USE_EB
+    const bool has_eb = !m_ebfactory.empty() && m_ebfactory[a_lev] != nullptr;
+    if (has_eb && !m_ebfactory[a_lev]->isAllRegular()) {
+        m_linop->compGrad(a_lev, m_fluxes[a_lev], m_phi[a_lev]);
+        fused_grad = false;
+    }
+#endif
+
+    const auto dxinv = m_geom[a_lev].InvCellSizeArray();
+    const bool has_sigma = !m_sigma.empty();
+    const bool has_alpha = m_has_alpha;
+    const Real const_sigma = m_const_sigma;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(m_fluxes[a_lev], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+
+        Array4<Real      > const& vel   = m_vel[a_lev]->array(mfi);
+        Array4<Real      > const& grad  = m_fluxes[a_lev].array(mfi);
+        Array4<Real const> const& phi   = m_phi[a_lev].const_array(mfi);
+        Array4<Real const> const& sigma = has_sigma ? m_sigma[a_lev]->const_array(mfi)
+                                                    : Array4<Real const>{};
+        Array4<Real const> const& alpha = has_alpha ? m_alpha[a_lev]->const_array(mfi)
+                                                    : Array4<Real const>{};
+
+        if (fused_grad)
+        {
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // Cell-centered gradient of the nodal phi
+#if (AMREX_SPACEDIM == 2)
+                Real g[2];
+                g[0] = Real(0.5)*dxinv[0]*( phi(i+1,j  ,k) - phi(i,j  ,k)
+                                          + phi(i+1,j+1,k) - phi(i,j+1,k) );
+                g[1] = Real(0.5)*dxinv[1]*( phi(i  ,j+1,k) - phi(i  ,j,k)
+                                          + phi(i+1,j+1,k) - phi(i+1,j,k) );
+#else
+                Real g[3];
+                g[0] = Real(0.25)*dxinv[0]*( phi(i+1,j  ,k  ) - phi(i,j  ,k  )
+                                           + phi(i+1,j+1,k  ) - phi(i,j+1,k  )
+                                           + phi(i+1,j  ,k+1) - phi(i,j  ,k+1)
+                                           + phi(i+1,j+1,k+1) - phi(i,j+1,k+1) );
+                g[1] = Real(0.25)*dxinv[1]*( phi(i  ,j+1,k  ) - phi(i  ,j,k  )
+                                           + phi(i+1,j+1,k  ) - phi(i+1,j,k  )
+                                           + phi(i  ,j+1,k+1) - phi(i  ,j,k+1)
+                                           + phi(i+1,j+1,k+1) - phi(i+1,j,k+1) );
+                g[2] = Real(0.25)*dxinv[2]*( phi(i  ,j  ,k+1) - phi(i  ,j  ,k)
+                                           + phi(i+1,j  ,k+1) - phi(i+1,j  ,k)
+                                           + phi(i  ,j+1,k+1) - phi(i  ,j+1,k)
+                                           + phi(i+1,j+1,k+1) - phi(i+1,j+1,k) );
+#endif
+                Real fac = has_sigma ? sigma(i,j,k) : const_sigma;
+                if (has_alpha) { fac /= alpha(i,j,k); }
+
+                for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                    grad(i,j,k,n) = g[n];
+                    vel(i,j,k,n) -= fac * g[n];
+                }
+            });
+        }
+#ifdef AMREX_USE_EB
+        else
+        {
+            const auto& flagfab = m_ebfactory[a_lev]->getMultiEBCellFlagFab()[mfi];
+            if (flagfab.getType(bx) == FabType::covered) { continue; }
+
+            Array4<EBCellFlag const> const& flag = flagfab.const_array();
+
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                if (flag(i,j,k).isCovered()) { return; }
+
+                Real fac = has_sigma ? sigma(i,j,k) : const_sigma;
+                if (has_alpha) { fac /= alpha(i,j,k); }
+
+                for (int n = 0; n < AMREX_SPACEDIM; ++n) {
+                    vel(i,j,k,n) -= fac * grad(i,j,k,n);
+                }
+            });
+        }
+#endif
+    }
+}
+
+ProjectionStats
 NodalProjector::project ( const Vector<MultiFab*>& a_phi, Real a_rtol, Real a_atol )
 {
     AMREX_ALWAYS_ASSERT(a_phi.size()==m_phi.size());
 
+    if (m_alias_phi)
+    {
+        bindPhi(a_phi);
+
+        ProjectionStats stats = project(a_rtol, a_atol);
+
+        // Do not keep pointing to the caller's data
+        for (int lev=0; lev < m_phi.size(); ++lev )
+        {
+            m_phi[lev].clear();
+        }
+
+        return stats;
+    }
+
     for (int lev=0; lev < m_phi.size(); ++lev )
     {
         MultiFab::Copy(m_phi[lev],*a_phi[lev],0,0,1,m_phi[lev].nGrow());
     }
 
-    project(a_rtol, a_atol);
+    ProjectionStats stats = project(a_rtol, a_atol);
 
     for (int lev=0; lev < m_phi.size(); ++lev )
     {
         MultiFab::Copy(*a_phi[lev],m_phi[lev],0,0,1,m_phi[lev].nGrow());
     }
+
+    return stats;
 }
 
 
@@ -439,6 +848,7 @@ NodalProjector::computeSyncResidual ()
 void
 NodalProjector::setCoarseBoundaryVelocityForSync ()
 {
+    BL_PROFILE("NodalProjector::setCoarseBoundaryVelocityForSync");
 
     const BoxArray& grids = m_vel[0]->boxArray();
     const Box& domainBox  = m_geom[0].Domain();
@@ -496,6 +906,7 @@ NodalProjector::setCoarseBoundaryVelocityForSync ()
 void
 NodalProjector::averageDown (const amrex::Vector<amrex::MultiFab*> a_var)
 {
+    BL_PROFILE("NodalProjector::averageDown");
 
     int f_lev = a_var.size()-1;
     int c_lev = 0;
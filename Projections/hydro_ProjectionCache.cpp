@@ -0,0 +1,86 @@
+#ifdef AMREX_USE_EB
+#include <AMReX_EBFabFactory.H>
+#endif
+
+#include <hydro_ProjectionCache.H>
+
+using namespace amrex;
+
+namespace Hydro {
+
+// Limit these to this file
+namespace {
+
+bool
+sameGeometry (Geometry const& a, Geometry const& b)
+{
+    if (a.Domain() != b.Domain() || a.Coord() != b.Coord()) { return false; }
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (a.ProbLo(idim)     != b.ProbLo(idim) ||
+            a.ProbHi(idim)     != b.ProbHi(idim) ||
+            a.isPeriodic(idim) != b.isPeriodic(idim)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// EB data of a factory, nullptr if it has none. Clones of a factory share it.
+void const*
+ebData (FabFactory<FArrayBox> const* a_factory)
+{
+#ifdef AMREX_USE_EB
+    auto const* ebfactory = dynamic_cast<EBFArrayBoxFactory const*>(a_factory);
+    if (ebfactory) { return &(ebfactory->getMultiEBCellFlagFab()); }
+#else
+    amrex::ignore_unused(a_factory);
+#endif
+    return nullptr;
+}
+
+}
+
+ProjectionCacheKey::ProjectionCacheKey (const Vector<Geometry>& a_geom,
+                                        const Vector<BoxArray>& a_grids,
+                                        const Vector<DistributionMapping>& a_dmap,
+                                        const Vector<FabFactory<FArrayBox> const*>& a_factory)
+    : geom(a_geom),
+      dmap(a_dmap)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_grids.size() == a_dmap.size() &&
+                                     a_geom.size() >= a_grids.size(),
+                                     "ProjectionCacheKey: inconsistent number of levels");
+
+    const int nlevs = a_grids.size();
+    geom.resize(nlevs);
+
+    factory.resize(nlevs);
+    for (int lev = 0; lev < nlevs && lev < a_factory.size(); ++lev) {
+        if (a_factory[lev]) {
+            factory[lev].reset(a_factory[lev]->clone());
+        }
+    }
+
+    grids.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        grids[lev] = amrex::convert(a_grids[lev], IntVect::TheZeroVector());
+    }
+}
+
+bool
+ProjectionCacheKey::operator== (ProjectionCacheKey const& a_rhs) const
+{
+    if (grids.size() != a_rhs.grids.size()) { return false; }
+
+    for (int lev = 0; lev < grids.size(); ++lev) {
+        if (ebData(factory[lev].get()) != ebData(a_rhs.factory[lev].get()) ||
+            !sameGeometry(geom[lev], a_rhs.geom[lev]) ||
+            dmap[lev]  != a_rhs.dmap[lev] ||
+            grids[lev] != a_rhs.grids[lev]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
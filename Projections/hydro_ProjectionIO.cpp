@@ -0,0 +1,123 @@
+#include <AMReX_BCRec.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_PlotFileUtil.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <hydro_ProjectionIO.H>
+
+using namespace amrex;
+
+namespace Hydro {
+
+// Limit these to this file
+namespace {
+
+//
+// Interpolate a_crse, on the level below a_fgeom, onto the valid region of
+// a_fine. Cell-centered data is taken piecewise constant and nodal data is
+// interpolated bilinearly, so that no coarse data is needed beyond the coarse
+// cells or nodes under a_fine. This is only a starting guess; the fine grids
+// must be properly nested in the coarse ones.
+//
+void
+interpFromCoarse (MultiFab& a_fine, MultiFab const& a_crse,
+                  Geometry const& a_cgeom, Geometry const& a_fgeom)
+{
+    IntVect ratio;
+    BCRec bcr;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        ratio[idim] = a_fgeom.Domain().length(idim) / a_cgeom.Domain().length(idim);
+        const int bctype = a_fgeom.isPeriodic(idim) ? BCType::int_dir : BCType::foextrap;
+        bcr.setLo(idim, bctype);
+        bcr.setHi(idim, bctype);
+    }
+
+    Interpolater* mapper = a_fine.ixType().cellCentered()
+        ? static_cast<Interpolater*>(&pc_interp)
+        : static_cast<Interpolater*>(&node_bilinear_interp);
+
+    PhysBCFunctNoOp physbc;
+    InterpFromCoarseLevel(a_fine, Real(0.0), a_crse, 0, 0, 1, a_cgeom, a_fgeom,
+                          physbc, 0, physbc, 0, ratio, mapper, {bcr}, 0);
+}
+
+}
+
+void
+writeProjectionPhi (std::string const& a_dir, Vector<MultiFab const*> const& a_phi)
+{
+    BL_PROFILE("Hydro::writeProjectionPhi");
+
+    const int nlevs = a_phi.size();
+    amrex::PreBuildDirectorHierarchy(a_dir, "Level_", nlevs, true);
+
+    for (int lev = 0; lev < nlevs; ++lev)
+    {
+        std::string const prefix = amrex::MultiFabFileFullPrefix(lev, a_dir, "Level_", "phi");
+
+        if (a_phi[lev]->nGrow() == 0)
+        {
+            VisMF::Write(*a_phi[lev], prefix);
+        }
+        else
+        {
+            MultiFab valid(a_phi[lev]->boxArray(), a_phi[lev]->DistributionMap(), 1, 0);
+            MultiFab::Copy(valid, *a_phi[lev], 0, 0, 1, 0);
+            VisMF::Write(valid, prefix);
+        }
+    }
+}
+
+int
+readProjectionPhi (std::string const& a_dir, Vector<MultiFab*> const& a_phi,
+                   Vector<Geometry> const& a_geom)
+{
+    BL_PROFILE("Hydro::readProjectionPhi");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(a_geom.size() >= a_phi.size(),
+                                     "readProjectionPhi: a_geom needs one Geometry per level");
+
+    int nread = 0;
+    for (int lev = 0; lev < a_phi.size(); ++lev)
+    {
+        std::string const prefix = amrex::MultiFabFileFullPrefix(lev, a_dir, "Level_", "phi");
+
+        // VisMF::Read is collective, so the ranks must agree on whether to call it
+        int exists = ParallelDescriptor::IOProcessor() ? int(amrex::FileExists(prefix + "_H")) : 0;
+        ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+        if (!exists) { break; }
+
+        MultiFab stored;
+        VisMF::Read(stored, prefix);
+
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(stored.ixType() == a_phi[lev]->ixType(),
+                                         "readProjectionPhi: stored phi has another index type");
+
+        MultiFab& phi = *a_phi[lev];
+        phi.setVal(0.0);
+        if (stored.boxArray() == phi.boxArray() && stored.DistributionMap() == phi.DistributionMap())
+        {
+            MultiFab::Copy(phi, stored, 0, 0, 1, 0);
+        }
+        else
+        {
+            // Start from the level below, already read, where the old grids do not reach
+            if (lev > 0)
+            {
+                MultiFab fine(phi.boxArray(), phi.DistributionMap(), 1, 0);
+                interpFromCoarse(fine, *a_phi[lev-1], a_geom[lev-1], a_geom[lev]);
+                MultiFab::Copy(phi, fine, 0, 0, 1, 0);
+            }
+            phi.ParallelCopy(stored, 0, 0, 1);
+        }
+
+        ++nread;
+    }
+    return nread;
+}
+
+}
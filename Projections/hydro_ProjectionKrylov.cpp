@@ -0,0 +1,524 @@
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <hydro_ProjectionKrylov.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+namespace Hydro {
+
+// Limit these to this file
+namespace {
+
+//
+// Vector operations of the Krylov methods on AMR level 0 of the operator.
+// The preconditioner is z = S(r) - S(0), where S is a fixed number of
+// V-cycles of the MLMG started from zero. S is affine in r when the level
+// has inhomogeneous BC data, and subtracting S(0) keeps only the part that
+// acts on r.
+//
+struct KrylovOps
+{
+    KrylovOps (MLLinOp& a_linop, MLMG& a_precond)
+        : linop(a_linop), precond(a_precond), ncomp(a_linop.getNComp())
+    {}
+
+    MultiFab make () const { return linop.make(0, 0, IntVect(1)); }
+
+    void apply (MultiFab& out, MultiFab& in) const
+    {
+        linop.apply(0, 0, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+    }
+
+    Real dot (MultiFab const& x, MultiFab const& y) const { return linop.xdoty(0, 0, x, y, false); }
+
+    Real norm (MultiFab const& x) const { return linop.normInf(0, x, false); }
+
+    void setupPrecond ()
+    {
+        MultiFab zero = make();
+        zero.setVal(0.0);
+        s0 = make();
+        s0.setVal(0.0);
+        precond.solve({&s0}, {&zero}, Real(0.0), Real(0.0));
+        num_cycles += precond.getNumIters();
+        has_s0 = (norm(s0) > Real(0.0));
+    }
+
+    void precondition (MultiFab& z, MultiFab const& r)
+    {
+        z.setVal(0.0);
+        precond.solve({&z}, {&r}, Real(0.0), Real(0.0));
+        num_cycles += precond.getNumIters();
+        if (has_s0) {
+            MultiFab::Subtract(z, s0, 0, 0, ncomp, 0);
+        }
+    }
+
+    MLLinOp& linop;
+    MLMG& precond;
+    int ncomp;
+    MultiFab s0;
+    bool has_s0 = false;
+    int num_cycles = 0;
+};
+
+// Flexible CG. Updates e and r, returns the number of iterations.
+int
+pcg (KrylovOps& ops, MultiFab& e, MultiFab& r, Real target, int maxiter,
+     int verbose, bool& converged)
+{
+    const int ncomp = ops.ncomp;
+    MultiFab z = ops.make();
+    MultiFab p = ops.make();
+    MultiFab q = ops.make();
+
+    ops.precondition(z, r);
+    MultiFab::Copy(p, z, 0, 0, ncomp, 0);
+    Real rz = ops.dot(r, z);
+
+    int iter = 0;
+    while (iter < maxiter)
+    {
+        ++iter;
+
+        ops.apply(q, p);
+        const Real pq = ops.dot(p, q);
+        if (pq == Real(0.0)) { break; }
+        const Real alpha = rz / pq;
+
+        MultiFab::Saxpy(e, alpha, p, 0, 0, ncomp, 0);
+        MultiFab::Saxpy(r, -alpha, q, 0, 0, ncomp, 0);
+
+        const Real rnorm = ops.norm(r);
+        if (verbose > 1) {
+            amrex::Print() << "  PCG iteration " << iter << ", resid = " << rnorm << '\n';
+        }
+        if (rnorm <= target) { converged = true; break; }
+
+        ops.precondition(z, r);
+
+        // Polak-Ribiere beta, z_new.(r_new - r_old)/rz, with r_new - r_old = -alpha q,
+        // so that a varying preconditioner does not break the method
+        const Real beta = -alpha * ops.dot(z, q) / rz;
+        rz = ops.dot(r, z);
+        MultiFab::Xpay(p, beta, z, 0, 0, ncomp, 0);
+    }
+    return iter;
+}
+
+// Right preconditioned BiCGStab. Updates e and r, returns the number of iterations.
+int
+bicgstab (KrylovOps& ops, MultiFab& e, MultiFab& r, Real target, int maxiter,
+          int verbose, bool& converged)
+{
+    const int ncomp = ops.ncomp;
+    MultiFab rhat = ops.make();
+    MultiFab p    = ops.make();
+    MultiFab v    = ops.make();
+    MultiFab phat = ops.make();
+    MultiFab shat = ops.make();
+    MultiFab t    = ops.make();
+
+    MultiFab::Copy(rhat, r, 0, 0, ncomp, 0);
+    p.setVal(0.0);
+    v.setVal(0.0);
+
+    Real rho_old = 1.0, alpha = 1.0, omega = 1.0;
+
+    int iter = 0;
+    while (iter < maxiter)
+    {
+        ++iter;
+
+        const Real rho = ops.dot(rhat, r);
+        if (rho == Real(0.0)) { break; }
+
+        if (iter == 1) {
+            MultiFab::Copy(p, r, 0, 0, ncomp, 0);
+        } else {
+            const Real beta = (rho/rho_old) * (alpha/omega);
+            MultiFab::Saxpy(p, -omega, v, 0, 0, ncomp, 0);
+            MultiFab::Xpay(p, beta, r, 0, 0, ncomp, 0);
+        }
+
+        ops.precondition(phat, p);
+        ops.apply(v, phat);
+        const Real rv = ops.dot(rhat, v);
+        if (rv == Real(0.0)) { break; }
+        alpha = rho / rv;
+
+        MultiFab::Saxpy(e, alpha, phat, 0, 0, ncomp, 0);
+        MultiFab::Saxpy(r, -alpha, v, 0, 0, ncomp, 0);
+
+        Real rnorm = ops.norm(r);
+        if (rnorm <= target) { converged = true; }
+        else
+        {
+            ops.precondition(shat, r);
+            ops.apply(t, shat);
+            const Real tt = ops.dot(t, t);
+            if (tt == Real(0.0)) { break; }
+            omega = ops.dot(t, r) / tt;
+
+            MultiFab::Saxpy(e, omega, shat, 0, 0, ncomp, 0);
+            MultiFab::Saxpy(r, -omega, t, 0, 0, ncomp, 0);
+
+            rnorm = ops.norm(r);
+            converged = (rnorm <= target);
+        }
+
+        if (verbose > 1) {
+            amrex::Print() << "  BiCGStab iteration " << iter << ", resid = " << rnorm << '\n';
+        }
+        if (converged || omega == Real(0.0)) { break; }
+
+        rho_old = rho;
+    }
+    return iter;
+}
+
+// Flexible GMRES(restart). Updates e and r, returns the number of iterations.
+// r is recomputed from the solution at every restart, which needs sol and rhs.
+int
+gmres (KrylovOps& ops, MultiFab& e, MultiFab& r, MultiFab& sol, MultiFab const& rhs,
+       Real reltol, Real target, int maxiter, int restart, int verbose, bool& converged)
+{
+    const int ncomp = ops.ncomp;
+    const int m = restart;
+
+    Vector<MultiFab> V(m+1);
+    Vector<MultiFab> Z(m);
+    for (auto& mf : V) { mf = ops.make(); }
+    for (auto& mf : Z) { mf = ops.make(); }
+    MultiFab x = ops.make();
+
+    Vector<Real> H((m+1)*m, 0.0);
+    auto h = [&H,m] (int i, int j) -> Real& { return H[i*m+j]; };
+    Vector<Real> cs(m), sn(m), g(m+1), y(m);
+
+    const Real beta0 = std::sqrt(ops.dot(r, r));
+
+    int iter = 0;
+    while (iter < maxiter && !converged)
+    {
+        const Real beta = std::sqrt(ops.dot(r, r));
+        if (beta == Real(0.0)) { converged = true; break; }
+
+        MultiFab::Copy(V[0], r, 0, 0, ncomp, 0);
+        V[0].mult(Real(1.0)/beta, 0, ncomp);
+        std::fill(g.begin(), g.end(), Real(0.0));
+        g[0] = beta;
+
+        int j = 0;
+        while (j < m && iter < maxiter)
+        {
+            ++iter;
+
+            ops.precondition(Z[j], V[j]);
+            ops.apply(V[j+1], Z[j]);
+
+            // Modified Gram-Schmidt
+            for (int i = 0; i <= j; ++i) {
+                h(i,j) = ops.dot(V[j+1], V[i]);
+                MultiFab::Saxpy(V[j+1], -h(i,j), V[i], 0, 0, ncomp, 0);
+            }
+            h(j+1,j) = std::sqrt(ops.dot(V[j+1], V[j+1]));
+            const bool breakdown = (h(j+1,j) == Real(0.0));
+            if (!breakdown) {
+                V[j+1].mult(Real(1.0)/h(j+1,j), 0, ncomp);
+            }
+
+            // Apply the previous Givens rotations to the new column, then
+            // eliminate h(j+1,j)
+            for (int i = 0; i < j; ++i) {
+                const Real tmp = cs[i]*h(i,j) + sn[i]*h(i+1,j);
+                h(i+1,j) = -sn[i]*h(i,j) + cs[i]*h(i+1,j);
+                h(i,j) = tmp;
+            }
+            const Real denom = std::sqrt(h(j,j)*h(j,j) + h(j+1,j)*h(j+1,j));
+            cs[j] = h(j,j) / denom;
+            sn[j] = h(j+1,j) / denom;
+            h(j,j) = denom;
+            h(j+1,j) = 0.0;
+            g[j+1] = -sn[j]*g[j];
+            g[j]   =  cs[j]*g[j];
+
+            ++j;
+
+            if (verbose > 1) {
+                amrex::Print() << "  GMRES iteration " << iter
+                               << ", 2-norm resid estimate = " << std::abs(g[j]) << '\n';
+            }
+            if (breakdown || std::abs(g[j]) <= reltol*beta0) { break; }
+        }
+
+        // e += Z y, with H y = g
+        for (int i = j-1; i >= 0; --i) {
+            Real sum = g[i];
+            for (int k = i+1; k < j; ++k) {
+                sum -= h(i,k)*y[k];
+            }
+            y[i] = sum / h(i,i);
+        }
+        for (int i = 0; i < j; ++i) {
+            MultiFab::Saxpy(e, y[i], Z[i], 0, 0, ncomp, 0);
+        }
+
+        // True residual of sol + e
+        MultiFab::LinComb(x, Real(1.0), sol, 0, Real(1.0), e, 0, 0, ncomp, 0);
+        ops.precond.compResidual({&r}, {&x}, {&rhs});
+
+        const Real rnorm = ops.norm(r);
+        if (verbose > 1) {
+            amrex::Print() << "  GMRES restart after " << iter << " iterations, resid = " << rnorm << '\n';
+        }
+        converged = (rnorm <= target);
+    }
+    return iter;
+}
+
+// dst = scale*src, converting between the precisions of the two
+template <typename DMF, typename SMF>
+void
+copyScaled (DMF& dst, SMF const& src, Real scale, int ncomp)
+{
+    using T = typename DMF::value_type;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dst, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.tilebox();
+        auto const& d = dst.array(mfi);
+        auto const& s = src.const_array(mfi);
+        amrex::ParallelFor(bx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            d(i,j,k,n) = static_cast<T>(scale * s(i,j,k,n));
+        });
+    }
+}
+
+// Iterative refinement: e += S(r), with S the single precision V-cycles and the
+// residual r = rhs - L(sol + e) recomputed in double after every correction.
+// r is scaled to unit max norm before it is converted, so that small residuals
+// do not underflow in float. Updates e and r, returns the number of corrections.
+int
+refinement (KrylovOps& ops, MLMGT<fMultiFab>& fprecond, MultiFab& e, MultiFab& r,
+            MultiFab& sol, MultiFab const& rhs, Real target, int maxiter, int verbose,
+            bool& converged)
+{
+    const int ncomp = ops.ncomp;
+    MultiFab z = ops.make();
+    MultiFab x = ops.make();
+    fMultiFab fr(r.boxArray(), r.DistributionMap(), ncomp, 0);
+    fMultiFab fz(r.boxArray(), r.DistributionMap(), ncomp, 1);
+
+    Real rnorm = ops.norm(r);
+
+    int iter = 0;
+    while (iter < maxiter)
+    {
+        ++iter;
+
+        copyScaled(fr, r, Real(1.0)/rnorm, ncomp);
+        fz.setVal(0.0f);
+        fprecond.solve({&fz}, {&fr}, 0.0f, 0.0f);
+        ops.num_cycles += fprecond.getNumIters();
+        copyScaled(z, fz, rnorm, ncomp);
+        MultiFab::Add(e, z, 0, 0, ncomp, 0);
+
+        MultiFab::LinComb(x, Real(1.0), sol, 0, Real(1.0), e, 0, 0, ncomp, 0);
+        ops.precond.compResidual({&r}, {&x}, {&rhs});
+
+        rnorm = ops.norm(r);
+        if (verbose > 1) {
+            amrex::Print() << "  Refinement step " << iter << ", resid = " << rnorm << '\n';
+        }
+        if (rnorm <= target) { converged = true; break; }
+    }
+    return iter;
+}
+
+void
+printSummary (std::string const& prefix, std::string const& method, bool converged,
+              int iter, int num_cycles, ProjectionStats const& stats)
+{
+    amrex::Print() << prefix << ": " << method << " "
+                   << (converged ? "converged" : "did NOT converge")
+                   << " in " << iter << " iterations (" << num_cycles
+                   << " V-cycles), resid " << stats.initial_residual
+                   << " -> " << stats.final_residual << '\n';
+}
+}
+
+void
+ProjectionKrylov::readParameters (std::string const& a_prefix)
+{
+    m_prefix = a_prefix;
+
+    std::string top_solver("mlmg");
+
+    ParmParse pp(a_prefix);
+    pp.query( "top_solver"        , top_solver );
+    pp.query( "top_maxiter"       , m_maxiter );
+    pp.query( "top_vcycles"       , m_precond_cycles );
+    pp.query( "top_gmres_restart" , m_gmres_restart );
+
+    if (top_solver == "mlmg")
+    {
+        m_type = Type::MLMG;
+    }
+    else if (top_solver == "pcg")
+    {
+        m_type = Type::PCG;
+    }
+    else if (top_solver == "bicgstab")
+    {
+        m_type = Type::BiCGStab;
+    }
+    else if (top_solver == "gmres")
+    {
+        m_type = Type::GMRES;
+    }
+    else if (top_solver == "refine")
+    {
+        m_type = Type::Refine;
+    }
+    else
+    {
+        amrex::Abort("ProjectionKrylov: unknown " + a_prefix + ".top_solver = " + top_solver);
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_maxiter > 0 && m_precond_cycles > 0 && m_gmres_restart > 0,
+                                     "ProjectionKrylov: top_maxiter, top_vcycles and top_gmres_restart must be positive");
+}
+
+bool
+ProjectionKrylov::isActive (int a_nlevs) const
+{
+    if (m_type == Type::MLMG) {
+        return false;
+    }
+
+    if (a_nlevs != 1) {
+        if (!m_warned_inactive && ParallelDescriptor::IOProcessor()) {
+            amrex::Warning("ProjectionKrylov: " + m_prefix + ".top_solver only works on a single AMR level,"
+                           " solving with MLMG alone on " + std::to_string(a_nlevs) + " levels");
+        }
+        m_warned_inactive = true;
+        return false;
+    }
+
+    return true;
+}
+
+ProjectionStats
+ProjectionKrylov::solve (MLLinOp& a_linop, MLMG& a_precond,
+                         MultiFab& a_sol, MultiFab const& a_rhs,
+                         Real a_reltol, Real a_atol, int a_verbose) const
+{
+    BL_PROFILE("ProjectionKrylov::solve");
+
+    AMREX_ALWAYS_ASSERT(m_type != Type::MLMG);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_type != Type::Refine,
+                                     "ProjectionKrylov::solve: use refine for top_solver = refine");
+
+    a_precond.setFixedIter(m_precond_cycles);
+    a_precond.setMaxIter(m_precond_cycles);
+    a_precond.setVerbose(0);
+
+    KrylovOps ops(a_linop, a_precond);
+    ops.setupPrecond();
+
+    const int ncomp = ops.ncomp;
+
+    MultiFab r = ops.make();
+    a_precond.compResidual({&r}, {&a_sol}, {&a_rhs});
+
+    ProjectionStats stats;
+    stats.initial_residual = ops.norm(r);
+
+    const Real target = amrex::max(a_reltol*stats.initial_residual, a_atol);
+
+    MultiFab e = ops.make();
+    e.setVal(0.0);
+
+    bool converged = (stats.initial_residual <= target);
+    int iter = 0;
+    if (!converged)
+    {
+        if (m_type == Type::PCG) {
+            iter = pcg(ops, e, r, target, m_maxiter, a_verbose, converged);
+        } else if (m_type == Type::BiCGStab) {
+            iter = bicgstab(ops, e, r, target, m_maxiter, a_verbose, converged);
+        } else {
+            iter = gmres(ops, e, r, a_sol, a_rhs, a_reltol, target,
+                         m_maxiter, m_gmres_restart, a_verbose, converged);
+        }
+        MultiFab::Add(a_sol, e, 0, 0, ncomp, 0);
+    }
+
+    stats.krylov_iterations = iter;
+    stats.iterations        = ops.num_cycles;
+    stats.final_residual    = ops.norm(r);
+
+    if (a_verbose > 0) {
+        printSummary(m_prefix, "Krylov top solver", converged, iter, ops.num_cycles, stats);
+    }
+
+    return stats;
+}
+
+ProjectionStats
+ProjectionKrylov::refine (MLLinOp& a_linop, MLMG& a_mlmg, MLMGT<fMultiFab>& a_precond,
+                          MultiFab& a_sol, MultiFab const& a_rhs,
+                          Real a_reltol, Real a_atol, int a_verbose) const
+{
+    BL_PROFILE("ProjectionKrylov::refine");
+
+    AMREX_ALWAYS_ASSERT(m_type == Type::Refine);
+
+    a_precond.setFixedIter(m_precond_cycles);
+    a_precond.setMaxIter(m_precond_cycles);
+    a_precond.setVerbose(0);
+
+    // The preconditioner of ops is only used for the residuals here
+    KrylovOps ops(a_linop, a_mlmg);
+
+    const int ncomp = ops.ncomp;
+
+    MultiFab r = ops.make();
+    a_mlmg.compResidual({&r}, {&a_sol}, {&a_rhs});
+
+    ProjectionStats stats;
+    stats.initial_residual = ops.norm(r);
+
+    const Real target = amrex::max(a_reltol*stats.initial_residual, a_atol);
+
+    bool converged = (stats.initial_residual <= target);
+    int iter = 0;
+    if (!converged)
+    {
+        MultiFab e = ops.make();
+        e.setVal(0.0);
+        iter = refinement(ops, a_precond, e, r, a_sol, a_rhs, target, m_maxiter,
+                          a_verbose, converged);
+        MultiFab::Add(a_sol, e, 0, 0, ncomp, 0);
+    }
+
+    stats.krylov_iterations = iter;
+    stats.iterations        = ops.num_cycles;
+    stats.final_residual    = ops.norm(r);
+
+    if (a_verbose > 0) {
+        printSummary(m_prefix, "Refinement", converged, iter, ops.num_cycles, stats);
+    }
+
+    return stats;
+}
+
+}
@@ -0,0 +1,94 @@
+#include <AMReX_Algorithm.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_Utility.H>
+
+#include <hydro_ProjectionStats.H>
+
+#include <ostream>
+
+using namespace amrex;
+
+namespace Hydro {
+
+Real
+ProjectionStats::clock (bool a_sync)
+{
+    if (a_sync) {
+        Gpu::streamSynchronize();
+    }
+    return amrex::second();
+}
+
+ProjectionStats&
+ProjectionStats::operator+= (ProjectionStats const& rhs) noexcept
+{
+    num_solves        += rhs.num_solves;
+    iterations        += rhs.iterations;
+    bottom_iterations += rhs.bottom_iterations;
+    krylov_iterations += rhs.krylov_iterations;
+    reltol             = amrex::max(reltol, rhs.reltol);
+    initial_residual   = amrex::max(initial_residual, rhs.initial_residual);
+    final_residual     = amrex::max(final_residual  , rhs.final_residual);
+    carried_residual   = amrex::max(carried_residual, rhs.carried_residual);
+
+    time_rhs          += rhs.time_rhs;
+    time_solve        += rhs.time_solve;
+    time_fluxes       += rhs.time_fluxes;
+    time_average_down += rhs.time_average_down;
+
+    num_fill_boundary += rhs.num_fill_boundary;
+
+    return *this;
+}
+
+void
+ProjectionStats::writeCSVHeader (std::ostream& os)
+{
+    os << "num_solves,iterations,bottom_iterations,krylov_iterations,reltol,initial_residual,final_residual,carried_residual,"
+       << "time_rhs,time_solve,time_fluxes,time_average_down,num_fill_boundary"
+       << '\n';
+}
+
+void
+ProjectionStats::writeCSV (std::ostream& os) const
+{
+    auto oldprec = os.precision(17);
+    os << num_solves        << ','
+       << iterations        << ','
+       << bottom_iterations << ','
+       << krylov_iterations << ','
+       << reltol            << ','
+       << initial_residual  << ','
+       << final_residual    << ','
+       << carried_residual  << ','
+       << time_rhs          << ','
+       << time_solve        << ','
+       << time_fluxes       << ','
+       << time_average_down << ','
+       << num_fill_boundary << '\n';
+    os.precision(oldprec);
+}
+
+void
+ProjectionStats::writeJSON (std::ostream& os) const
+{
+    auto oldprec = os.precision(17);
+    os << "{"
+       << "\"num_solves\": "        << num_solves        << ", "
+       << "\"iterations\": "        << iterations        << ", "
+       << "\"bottom_iterations\": " << bottom_iterations << ", "
+       << "\"krylov_iterations\": " << krylov_iterations << ", "
+       << "\"reltol\": "            << reltol            << ", "
+       << "\"initial_residual\": "  << initial_residual  << ", "
+       << "\"final_residual\": "    << final_residual    << ", "
+       << "\"carried_residual\": "  << carried_residual  << ", "
+       << "\"time_rhs\": "          << time_rhs          << ", "
+       << "\"time_solve\": "        << time_solve        << ", "
+       << "\"time_fluxes\": "       << time_fluxes       << ", "
+       << "\"time_average_down\": " << time_average_down << ", "
+       << "\"num_fill_boundary\": " << num_fill_boundary
+       << "}";
+    os.precision(oldprec);
+}
+
+}
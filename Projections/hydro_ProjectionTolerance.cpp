@@ -0,0 +1,54 @@
+#include <AMReX_Algorithm.H>
+#include <AMReX_ParmParse.H>
+
+#include <hydro_ProjectionTolerance.H>
+
+using namespace amrex;
+
+namespace Hydro {
+
+void
+ProjectionTolerance::readParameters (std::string const& a_prefix)
+{
+    std::string tol_control("fixed");
+
+    ParmParse pp(a_prefix);
+    pp.query( "tol_control", tol_control );
+    pp.query( "tol_safety" , m_safety );
+    pp.query( "tol_max"    , m_max_reltol );
+
+    if (tol_control == "fixed")
+    {
+        m_mode = Mode::Fixed;
+    }
+    else if (tol_control == "truncation")
+    {
+        m_mode = Mode::Truncation;
+    }
+    else
+    {
+        amrex::Abort("ProjectionTolerance: unknown " + a_prefix + ".tol_control = " + tol_control);
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_safety > 0.0 && m_max_reltol > 0.0,
+                                     "ProjectionTolerance: tol_safety and tol_max must be positive");
+}
+
+Real
+ProjectionTolerance::chooseReltol (Real a_reltol, Real a_rhs_norm)
+{
+    Real target = -1.0;
+    if (m_mode == Mode::Truncation) {
+        target = m_safety * m_trunc_err;
+    }
+
+    Real reltol = a_reltol;
+    if (target > 0.0 && a_rhs_norm > 0.0) {
+        reltol = amrex::max(a_reltol, amrex::min(target/a_rhs_norm, m_max_reltol));
+    }
+
+    m_last_reltol = reltol;
+    return reltol;
+}
+
+}
@@ -0,0 +1,402 @@
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <hydro_ProjectionTuner.H>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace amrex;
+
+namespace Hydro {
+
+// Limit these to this file
+namespace {
+
+void
+setBottomSolver (MLMG& a_mlmg, std::string const& a_bottom_solver)
+{
+    if (a_bottom_solver == "smoother")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::smoother);
+    }
+    else if (a_bottom_solver == "bicg")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::bicgstab);
+    }
+    else if (a_bottom_solver == "cg")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::cg);
+    }
+    else if (a_bottom_solver == "bicgcg")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::bicgcg);
+    }
+    else if (a_bottom_solver == "cgbicg")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::cgbicg);
+    }
+#ifdef AMREX_USE_HYPRE
+    else if (a_bottom_solver == "hypre")
+    {
+        a_mlmg.setBottomSolver(MLMG::BottomSolver::hypre);
+    }
+#endif
+}
+
+void
+writeConfig (std::ostream& os, ProjectionTuner::Config const& c)
+{
+    os << c.bottom_solver << " " << c.num_pre_smooth << " " << c.num_post_smooth << " "
+       << c.agglomeration << " " << c.consolidation << " " << c.max_coarsening_level;
+}
+
+void
+printConfig (std::string const& a_prefix, char const* a_what,
+             ProjectionTuner::Config const& c, Real a_cost)
+{
+    amrex::Print() << a_prefix << ": autotune " << a_what
+                   << " bottom_solver = " << c.bottom_solver
+                   << ", num_pre_smooth = " << c.num_pre_smooth
+                   << ", num_post_smooth = " << c.num_post_smooth
+                   << ", agglomeration = " << c.agglomeration
+                   << ", consolidation = " << c.consolidation
+                   << ", max_coarsening_level = " << c.max_coarsening_level;
+    if (a_cost >= Real(0.0)) {
+        amrex::Print() << " (" << a_cost << " s per decade)";
+    }
+    amrex::Print() << '\n';
+}
+
+}
+
+void
+ProjectionTuner::readParameters (std::string const& a_prefix,
+                                 std::string const& a_default_bottom_solver)
+{
+    m_prefix = a_prefix;
+
+    m_base = Config();
+    m_base.bottom_solver = a_default_bottom_solver;
+
+    m_bottom_solvers = {"bicg", "cg", "bicgcg"};
+    m_smooth = {2, 4};
+    m_coarsen.clear();
+
+    int autotune = 0;
+
+    ParmParse pp(a_prefix);
+    pp.query( "autotune"        , autotune );
+    pp.query( "autotune_trials" , m_trials );
+    pp.query( "autotune_cache"  , m_cache_file );
+    pp.queryarr( "autotune_bottom"  , m_bottom_solvers );
+    pp.queryarr( "autotune_smooth"  , m_smooth );
+    pp.queryarr( "autotune_coarsen" , m_coarsen );
+
+    pp.query( "bottom_solver"   , m_base.bottom_solver );
+    pp.query( "num_pre_smooth"  , m_base.num_pre_smooth );
+    pp.query( "num_post_smooth" , m_base.num_post_smooth );
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_trials > 0,
+                                     "ProjectionTuner: autotune_trials must be positive");
+
+    m_enabled = (autotune != 0);
+    m_started = false;
+    m_locked  = false;
+}
+
+void
+ProjectionTuner::start (std::string const& a_signature, LPInfo const& a_lpinfo,
+                        bool a_tune_lpinfo)
+{
+    m_signature   = a_signature;
+    m_tune_lpinfo = a_tune_lpinfo && !m_lpinfo_fixed;
+    m_started     = true;
+
+    m_base.agglomeration        = a_lpinfo.do_agglomeration;
+    m_base.consolidation        = a_lpinfo.do_consolidation;
+    m_base.max_coarsening_level = a_lpinfo.max_coarsening_level;
+
+    Config chosen;
+    if (readCache(a_signature, chosen))
+    {
+        if (!m_tune_lpinfo) {
+            chosen.agglomeration        = m_base.agglomeration;
+            chosen.consolidation        = m_base.consolidation;
+            chosen.max_coarsening_level = m_base.max_coarsening_level;
+        }
+        m_current = chosen;
+        m_locked = true;
+        return;
+    }
+
+    m_best           = m_base;
+    m_best_cost      = -1.0;
+    m_current        = m_base;
+    m_current_cost   = -1.0;
+    m_current_trials = 0;
+    m_next_setting   = 0;
+    m_queue.clear();
+    m_locked = false;
+}
+
+void
+ProjectionTuner::fixLPInfo (LPInfo const& a_lpinfo)
+{
+    if (m_lpinfo_fixed) { return; }
+
+    m_lpinfo_fixed = true;
+    m_tune_lpinfo  = false;
+
+    auto fix = [&a_lpinfo] (Config& c)
+    {
+        c.agglomeration        = a_lpinfo.do_agglomeration;
+        c.consolidation        = a_lpinfo.do_consolidation;
+        c.max_coarsening_level = a_lpinfo.max_coarsening_level;
+    };
+    fix(m_base);
+    fix(m_best);
+    fix(m_current);
+
+    // Queued changes of coarsening are now the same as the best configuration
+    for (auto& c : m_queue) { fix(c); }
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(),
+                                 [this] (Config const& c) {
+                                     return c.bottom_solver   == m_best.bottom_solver
+                                         && c.num_pre_smooth  == m_best.num_pre_smooth
+                                         && c.num_post_smooth == m_best.num_post_smooth;
+                                 }),
+                  m_queue.end());
+}
+
+LPInfo
+ProjectionTuner::lpinfo (LPInfo const& a_lpinfo) const
+{
+    LPInfo info = a_lpinfo;
+    if (m_started) {
+        info.setAgglomeration(m_current.agglomeration);
+        info.setConsolidation(m_current.consolidation);
+        info.setMaxCoarseningLevel(m_current.max_coarsening_level);
+    }
+    return info;
+}
+
+void
+ProjectionTuner::applyTo (MLMG& a_mlmg) const
+{
+    if (!m_enabled || !m_started) { return; }
+
+    setBottomSolver(a_mlmg, m_current.bottom_solver);
+    a_mlmg.setPreSmooth(m_current.num_pre_smooth);
+    a_mlmg.setPostSmooth(m_current.num_post_smooth);
+}
+
+void
+ProjectionTuner::record (ProjectionStats const& a_stats, int a_verbose)
+{
+    if (!isTuning() || a_stats.num_solves == 0) { return; }
+
+    Real time = a_stats.time_solve;
+    ParallelDescriptor::ReduceRealMax(time);
+
+    Real decades = Real(1.0);
+    if (a_stats.final_residual > Real(0.0) && a_stats.initial_residual > a_stats.final_residual) {
+        decades = amrex::max(decades, std::log10(a_stats.initial_residual/a_stats.final_residual));
+    }
+    const Real cost = time / decades;
+
+    if (m_current_cost < Real(0.0) || cost < m_current_cost) {
+        m_current_cost = cost;
+    }
+    if (++m_current_trials < m_trials) { return; }
+
+    if (a_verbose > 0) {
+        printConfig(m_prefix, "tried", m_current, m_current_cost);
+    }
+
+    if (m_best_cost < Real(0.0) || m_current_cost < m_best_cost) {
+        m_best      = m_current;
+        m_best_cost = m_current_cost;
+    }
+
+    nextConfig(a_verbose);
+}
+
+void
+ProjectionTuner::nextConfig (int a_verbose)
+{
+    constexpr int num_settings = 5;
+    while (m_queue.empty() && m_next_setting < num_settings) {
+        expandSetting(m_next_setting++);
+    }
+
+    if (m_queue.empty())
+    {
+        m_current = m_best;
+        m_locked  = true;
+        writeCache(m_signature, m_best);
+        if (a_verbose > 0) {
+            printConfig(m_prefix, "chose", m_best, m_best_cost);
+        }
+    }
+    else
+    {
+        m_current = m_queue.front();
+        m_queue.erase(m_queue.begin());
+        m_current_cost   = -1.0;
+        m_current_trials = 0;
+    }
+}
+
+// Queue the configurations differing from the best one in setting a_setting only
+void
+ProjectionTuner::expandSetting (int a_setting)
+{
+    if (a_setting == 0)
+    {
+        for (auto const& s : m_bottom_solvers) {
+            if (s != m_best.bottom_solver) {
+                Config c = m_best;
+                c.bottom_solver = s;
+                m_queue.push_back(c);
+            }
+        }
+    }
+    else if (a_setting == 1)
+    {
+        for (int n : m_smooth) {
+            if (n != m_best.num_pre_smooth || n != m_best.num_post_smooth) {
+                Config c = m_best;
+                c.num_pre_smooth  = n;
+                c.num_post_smooth = n;
+                m_queue.push_back(c);
+            }
+        }
+    }
+    else if (m_tune_lpinfo)
+    {
+        Config c = m_best;
+        if (a_setting == 2) {
+            c.agglomeration = !m_best.agglomeration;
+            m_queue.push_back(c);
+        } else if (a_setting == 3) {
+            c.consolidation = !m_best.consolidation;
+            m_queue.push_back(c);
+        } else {
+            for (int n : m_coarsen) {
+                if (n != m_best.max_coarsening_level) {
+                    c.max_coarsening_level = n;
+                    m_queue.push_back(c);
+                }
+            }
+        }
+    }
+}
+
+//
+// The cache file has one line per signature:
+//   signature bottom_solver num_pre_smooth num_post_smooth agglomeration consolidation max_coarsening_level
+//
+bool
+ProjectionTuner::readCache (std::string const& a_signature, Config& a_config) const
+{
+    if (m_cache_file.empty()) { return false; }
+
+    // ReadAndBcastFile is collective, so the ranks must agree on whether to call it
+    int exists = ParallelDescriptor::IOProcessor() ? int(amrex::FileExists(m_cache_file)) : 0;
+    ParallelDescriptor::Bcast(&exists, 1, ParallelDescriptor::IOProcessorNumber());
+    if (!exists) { return false; }
+
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(m_cache_file, buf, false);
+    if (buf.empty()) { return false; }
+
+    std::istringstream is(std::string(buf.dataPtr()), std::istringstream::in);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        std::istringstream ls(line);
+        std::string signature;
+        Config c;
+        if (ls >> signature >> c.bottom_solver >> c.num_pre_smooth >> c.num_post_smooth
+               >> c.agglomeration >> c.consolidation >> c.max_coarsening_level
+            && signature == a_signature)
+        {
+            a_config = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+ProjectionTuner::writeCache (std::string const& a_signature, Config const& a_config) const
+{
+    if (m_cache_file.empty() || !ParallelDescriptor::IOProcessor()) { return; }
+
+    // Keep the entries of other signatures
+    std::ostringstream entries;
+    {
+        std::ifstream ifs(m_cache_file);
+        std::string line;
+        while (std::getline(ifs, line)) {
+            std::istringstream ls(line);
+            std::string signature;
+            if ((ls >> signature) && signature != a_signature) {
+                entries << line << '\n';
+            }
+        }
+    }
+    entries << a_signature << " ";
+    writeConfig(entries, a_config);
+    entries << '\n';
+
+    std::ofstream ofs(m_cache_file, std::ios::trunc);
+    if (!ofs.good()) {
+        amrex::Warning("ProjectionTuner: could not write " + m_cache_file);
+        return;
+    }
+    ofs << entries.str();
+}
+
+std::string
+ProjectionTuner::gridSignature (std::string const& a_prefix,
+                                Vector<Geometry> const& a_geom,
+                                Vector<BoxArray> const& a_grids)
+{
+    std::ostringstream os;
+    os << AMREX_SPACEDIM << " " << ParallelDescriptor::NProcs();
+    for (int lev = 0; lev < a_grids.size(); ++lev) {
+        os << " " << a_geom[lev].Domain() << " " << a_grids[lev].size();
+        for (int i = 0; i < a_grids[lev].size(); ++i) {
+            os << a_grids[lev][i];
+        }
+    }
+
+    // 64-bit FNV-1a, so that the signature does not depend on the standard library
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (char c : os.str()) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+
+    std::ostringstream sig;
+    sig << a_prefix << "_" << a_grids.size() << "lev_" << std::hex << std::setw(16)
+        << std::setfill('0') << hash;
+    return sig.str();
+}
+
+bool
+ProjectionTuner::sameCoarsening (LPInfo const& a, LPInfo const& b) noexcept
+{
+    return a.do_agglomeration     == b.do_agglomeration
+        && a.do_consolidation     == b.do_consolidation
+        && a.max_coarsening_level == b.max_coarsening_level;
+}
+
+}
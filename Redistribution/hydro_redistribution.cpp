@@ -6,10 +6,29 @@
  */
 
 #include <hydro_redistribution.H>
+#include <hydro_utils.H>
+#include <hydro_kernel_capture.H>
 #include <AMReX_EB_utils.H>
+#include <AMReX_EBFabFactory.H>
 
 using namespace amrex;
 
+namespace {
+    // Does the part of flag on bx contain anything other than regular cells?
+    // This loops on the host, so flag must be host accessible.
+    bool has_cut_cells (Box const& bx, Array4<EBCellFlag const> const& flag)
+    {
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+        for (int i = lo.x; i <= hi.x; ++i) {
+            if (!flag(i,j,k).isRegular()) { return true; }
+        }}}
+        return false;
+    }
+}
+
 void Redistribution::Apply ( Box const& bx, int ncomp,
                              Array4<Real      > const& dUdt_out,
                              Array4<Real      > const& dUdt_in,
@@ -40,6 +59,39 @@ void Redistribution::Apply ( Box const& bx, int ncomp,
     // redistribution_type = "FluxRedist"      // flux_redistribute
     // redistribution_type = "StateRedist";    // (weighted) state redistribute
 
+    if (redistribution_type != "NoRedist" &&
+        redistribution_type != "FluxRedist" &&
+        redistribution_type != "StateRedist")
+    {
+       amrex::Error("Not a legit redist_type");
+    }
+
+    // If there are no cut cells near bx then no redistribution takes place and
+    //    dUdt_out is just dUdt_in, so we can skip building itracker, the
+    //    neighborhoods, etc. StateRedist builds itracker on grow(bx,4) while
+    //    FluxRedist only looks two cells out.
+    // On GPUs flag is in device memory and checking it here would need a
+    //    reduction and a sync per box, so this is left to ApplyMF, which uses
+    //    the cell type cached in the EBCellFlagFab.
+#ifdef AMREX_USE_GPU
+    const bool regular_nbhd = false;
+#else
+    const int nghost_regular = HydroUtils::nGrowRedistributionRegular(redistribution_type);
+    const bool regular_nbhd = !has_cut_cells(amrex::grow(bx,nghost_regular) & Box(flag), flag);
+#endif
+    if (redistribution_type == "NoRedist" || regular_nbhd)
+    {
+        if (dUdt_out.dataPtr() != dUdt_in.dataPtr())
+        {
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+                {
+                    dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
+                });
+        }
+        return;
+    }
+
     amrex::ParallelFor(bx,ncomp,
     [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
@@ -74,12 +126,6 @@ void Redistribution::Apply ( Box const& bx, int ncomp,
         // Total volume of all cells in my nbhd
         FArrayBox nbhd_vol_fab(bxg2,1,The_Async_Arena());
 
-        // scaled dUdt_in values
-        FArrayBox dUdt_in_scaled_fab(bxg4,ncomp);
-
-        // scaled U_in values
-        FArrayBox U_in_scaled_fab(bxg4,ncomp);
-
         // Centroid of my nbhd
         FArrayBox cent_hat_fab(bxg3,AMREX_SPACEDIM,The_Async_Arena());
 
@@ -99,6 +145,12 @@ void Redistribution::Apply ( Box const& bx, int ncomp,
         Array4<Real const> cent_hat_const = cent_hat_fab.const_array();
 
 #ifdef PELEC_USE_PLASMA
+        // scaled dUdt_in values
+        FArrayBox dUdt_in_scaled_fab(bxg4,ncomp);
+
+        // scaled U_in values
+        FArrayBox U_in_scaled_fab(bxg4,ncomp);
+
         Elixir eli_duin = dUdt_in_scaled_fab.elixir();
         Array4<Real      > dUdt_in_scaled       = dUdt_in_scaled_fab.array();
         Array4<Real const> dUdt_in_scaled_const = dUdt_in_scaled_fab.const_array();
@@ -174,25 +226,174 @@ void Redistribution::Apply ( Box const& bx, int ncomp,
 
                 if(n >= ufs && n < ufs + nspec ) dUdt_out(i,j,k,n) /= 6.0221409e23/mwts[n - ufs];
 #else
-                if ((itr(i,j,k,0) > 0 || nrs(i,j,k) > 1.)  )
+                if ((itr(i,j,k,0) > 0 || nrs(i,j,k) > 1.)  ) {
                    const Real scale = (srd_update_scale) ? srd_update_scale(i,j,k) : Real(1.0);
                    dUdt_out(i,j,k,n) = scale * (dUdt_out(i,j,k,n) - U_in(i,j,k,n)) / dt;
-                else
+                } else {
                    dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
+                }
 #endif
             }
         );
 
-    } else if (redistribution_type == "NoRedist") {
-        amrex::ParallelFor(bx, ncomp,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+    }
+}
+
+void
+Redistribution::ApplyMF ( MultiFab& dUdt_out,
+                          MultiFab& dUdt_in,
+                          MultiFab& U_in,
+                          int ncomp,
+                          amrex::BCRec  const* d_bcrec_ptr,
+                          Geometry const& lev_geom, Real dt,
+                          std::string const& redistribution_type
+#ifdef PELEC_USE_PLASMA
+                          ,
+                          int ufs, int nspec, int ufe, int nefc, Real *mwts
+#endif
+                          ,
+                          const int srd_max_order,
+                          amrex::Real target_volfrac,
+                          MultiFab const* srd_update_scale)
+{
+    BL_PROFILE("Redistribution::ApplyMF");
+
+    AMREX_ALWAYS_ASSERT(dUdt_in.hasEBFabFactory());
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(&dUdt_out != &dUdt_in,
+                                     "Redistribution::ApplyMF: dUdt_out and dUdt_in must be different MultiFabs");
+
+    if (redistribution_type == "NoRedist")
+    {
+        MultiFab::Copy(dUdt_out, dUdt_in, 0, 0, ncomp, 0);
+        return;
+    }
+
+    // nghost_state   : number of ghost cells of dUdt_in (and U_in) read by the stencil
+    // nghost_regular : a tile is left unchanged by the redistribution if there are
+    //                  no cut cells within this many cells of it
+    if (redistribution_type != "FluxRedist" && redistribution_type != "StateRedist")
+    {
+        amrex::Error("Not a legit redist_type");
+    }
+    const int nghost_state   = HydroUtils::nGrowRedistribution(redistribution_type);
+    const int nghost_regular = HydroUtils::nGrowRedistributionRegular(redistribution_type);
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(dUdt_in.nGrow() >= nghost_state,
+                                     "Redistribution::ApplyMF: dUdt_in does not have enough ghost cells");
+    dUdt_in.FillBoundary(0, ncomp, IntVect(nghost_state), lev_geom.periodicity());
+
+    if (redistribution_type == "StateRedist")
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(U_in.nGrow() >= nghost_state,
+                                         "Redistribution::ApplyMF: U_in does not have enough ghost cells");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!srd_update_scale || srd_update_scale->nGrow() >= nghost_state,
+                                         "Redistribution::ApplyMF: update_scale does not have enough ghost cells");
+        U_in.FillBoundary(0, ncomp, IntVect(nghost_state), lev_geom.periodicity());
+    }
+
+    auto const& ebfact = dynamic_cast<EBFArrayBoxFactory const&>(dUdt_in.Factory());
+    auto const& flags    = ebfact.getMultiEBCellFlagFab();
+    auto const& vfrac    = ebfact.getVolFrac();
+    auto const& ccent    = ebfact.getCentroid();
+    auto const& areafrac = ebfact.getAreaFrac();
+    auto const& facecent = ebfact.getFaceCent();
+
+    // The tile loop on its own, tagged with the scheme
+    BL_PROFILE_VAR("Redistribution::ApplyMF::" + redistribution_type, redist_tiles);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dUdt_out,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        Box const& bx = mfi.tilebox();
+
+        Array4<Real      > const& out = dUdt_out.array(mfi);
+        Array4<Real      > const& in  = dUdt_in.array(mfi);
+
+        EBCellFlagFab const& flagfab = flags[mfi];
+
+        if (flagfab.getType(bx) == FabType::covered)
+        {
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
             {
-                dUdt_out(i,j,k,n) = dUdt_in(i,j,k,n);
+                out(i,j,k,n) = 0.;
+            });
+        }
+        else if (flagfab.getType(amrex::grow(bx,nghost_regular)) == FabType::regular)
+        {
+            amrex::ParallelFor(bx, ncomp,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                out(i,j,k,n) = in(i,j,k,n);
+            });
+        }
+        else
+        {
+            Array4<EBCellFlag const> const& flag = flagfab.const_array();
+
+            AMREX_D_TERM(Array4<Real const> const& apx = areafrac[0]->const_array(mfi);,
+                         Array4<Real const> const& apy = areafrac[1]->const_array(mfi);,
+                         Array4<Real const> const& apz = areafrac[2]->const_array(mfi););
+
+            AMREX_D_TERM(Array4<Real const> const& fcx = facecent[0]->const_array(mfi);,
+                         Array4<Real const> const& fcy = facecent[1]->const_array(mfi);,
+                         Array4<Real const> const& fcz = facecent[2]->const_array(mfi););
+
+            Array4<Real const> const& vfrac_arr = vfrac.const_array(mfi);
+            Array4<Real const> const& ccc       = ccent.const_array(mfi);
+
+            // For FluxRedist scratch holds the weights, for StateRedist it holds U_in + dt * dUdt_in
+            FArrayBox scratch_fab(amrex::grow(bx,nghost_state), ncomp, The_Async_Arena());
+            if (redistribution_type == "FluxRedist")
+                scratch_fab.setVal<RunOn::Device>(1.0);
+
+            Array4<Real const> const& update_scale = (srd_update_scale)
+                ? srd_update_scale->const_array(mfi) : Array4<Real const>{};
+
+            // Save the inputs and outputs of this call if asked to by hydro.capture_box
+            const bool capture = HydroUtils::CaptureRequested("Redistribution::Apply", mfi.index());
+            HydroUtils::KernelArchive archive;
+            if (capture)
+            {
+                archive = HydroUtils::KernelArchive("Redistribution::Apply");
+                archive.addString("redistribution_type", redistribution_type);
+                archive.addBox("bx", bx);
+                archive.addInt("ncomp", ncomp);
+                archive.addBox("scratch_box", scratch_fab.box());
+                archive.addArray("dUdt_in", in);
+                archive.addArray("U_in", U_in.const_array(mfi));
+                archive.addFlags("flag", flag);
+                archive.addArray("vfrac", vfrac_arr);
+                archive.addArray("ccent", ccc);
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    archive.addArray("area"+std::to_string(d), areafrac[d]->const_array(mfi));
+                    archive.addArray("fcent"+std::to_string(d), facecent[d]->const_array(mfi));
+                }
+                archive.addBCRecs("bcrec", d_bcrec_ptr, ncomp);
+                archive.addGeometry("geom", lev_geom);
+                archive.addReal("dt", dt);
+                archive.addInt("srd_max_order", srd_max_order);
+                archive.addReal("target_volfrac", target_volfrac);
+                archive.addArray("update_scale", update_scale);
             }
-        );
 
-    } else {
-       amrex::Error("Not a legit redist_type");
+            Apply(bx, ncomp, out, in, U_in.const_array(mfi), scratch_fab.array(), flag,
+                  AMREX_D_DECL(apx, apy, apz), vfrac_arr,
+                  AMREX_D_DECL(fcx, fcy, fcz), ccc,
+                  d_bcrec_ptr, lev_geom, dt, redistribution_type
+#ifdef PELEC_USE_PLASMA
+                  , ufs, nspec, ufe, nefc, mwts
+#endif
+                  , srd_max_order, target_volfrac, update_scale);
+
+            if (capture)
+            {
+                archive.addArray("dUdt_out", out);
+                HydroUtils::WriteCapture(archive, mfi.index());
+            }
+        }
     }
 }
 
@@ -0,0 +1,306 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Reduce.H>
+
+#ifdef AMREX_USE_EB
+#include <AMReX_EB2.H>
+#include <AMReX_EB2_IF.H>
+#include <AMReX_EBFabFactory.H>
+#endif
+
+#include <hydro_utils.H>
+
+using namespace amrex;
+
+// Smooth but not polynomial data in the valid cells, so that the limiters are
+// exercised, and a large value in the ghost cells, so that reading a ghost
+// cell before it has been filled changes the result
+void init_data (MultiFab& mf, Real shift)
+{
+    mf.setVal(1.e10);
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Array4<Real> const& a = mf.array(mfi);
+        ParallelFor(mfi.validbox(), mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            a(i,j,k,n) = std::sin(Real(0.37)*i + Real(0.61)*j + Real(0.23)*k + Real(n) + shift)
+                       + Real(0.1)*std::cos(Real(1.7)*i*j + Real(0.9)*k);
+        });
+    }
+}
+
+// First order extrapolation into the ghost cells outside the non-periodic sides
+// of the domain. The corner cells copy from ghost cells filled by FillBoundary.
+void fill_physbc (MultiFab& mf, Geometry const& geom)
+{
+    Box const& domain = geom.Domain();
+    Box gdomain = domain;
+    GpuArray<int,AMREX_SPACEDIM> is_periodic;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        is_periodic[idim] = geom.isPeriodic(idim);
+        if (is_periodic[idim]) {
+            gdomain.grow(idim, mf.nGrow());
+        }
+    }
+    const auto dlo = amrex::lbound(domain);
+    const auto dhi = amrex::ubound(domain);
+
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        Box const& gbx = mfi.fabbox() & gdomain;
+        if (domain.contains(gbx)) {
+            continue;
+        }
+
+        Array4<Real> const& a = mf.array(mfi);
+        ParallelFor(gbx, mf.nComp(),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            AMREX_D_TERM(if (!is_periodic[0]) { iv[0] = amrex::Clamp(i, dlo.x, dhi.x); },
+                         if (!is_periodic[1]) { iv[1] = amrex::Clamp(j, dlo.y, dhi.y); },
+                         if (!is_periodic[2]) { iv[2] = amrex::Clamp(k, dlo.z, dhi.z); });
+            if (iv != IntVect(AMREX_D_DECL(i,j,k))) {
+                a(i,j,k,n) = a(iv,n);
+            }
+        });
+    }
+}
+
+// Abort unless a and b hold the same values everywhere, ghost cells included
+void check_identical (MultiFab const& a, MultiFab const& b, std::string const& name)
+{
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<Long> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        Array4<Real const> const& aa = a.const_array(mfi);
+        Array4<Real const> const& bb = b.const_array(mfi);
+        reduce_op.eval(mfi.fabbox(), a.nComp(), reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) -> ReduceTuple
+        {
+            return { (aa(i,j,k,n) != bb(i,j,k,n)) ? 1 : 0 };
+        });
+    }
+
+    Long ndiff = amrex::get<0>(reduce_data.value());
+    ParallelDescriptor::ReduceLongSum(ndiff);
+
+    if (ndiff != 0) {
+        amrex::Abort("Overlapped and blocking " + name + " differ in "
+                     + std::to_string(ndiff) + " values");
+    }
+    amrex::Print() << "   " << name << " identical" << std::endl;
+}
+
+MultiFab copy_of (MultiFab const& mf)
+{
+    MultiFab r(mf.boxArray(), mf.DistributionMap(), mf.nComp(), mf.nGrow(), MFInfo(), mf.Factory());
+    MultiFab::Copy(r, mf, 0, 0, mf.nComp(), mf.nGrow());
+    return r;
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        Vector<std::string> advection_types = {"MOL", "Godunov"};
+
+        // read parameters
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.queryarr("advection_types", advection_types);
+        }
+
+        // Periodic in x only, so that the callback has work to do on the other sides
+        Geometry geom;
+        BoxArray grids;
+        DistributionMapping dmap;
+        {
+            RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+            Array<int,AMREX_SPACEDIM> isp{AMREX_D_DECL(1,0,0)};
+            Box domain(IntVect(0), IntVect(n_cell-1));
+            geom.define(domain, rb, CoordSys::cartesian, isp);
+
+            grids.define(domain);
+            grids.maxSize(max_grid_size);
+
+            dmap.define(grids);
+        }
+
+#ifdef AMREX_USE_EB
+        // A sphere cutting through many boxes, so that there are tiles with cut
+        // cells only near their edges, which the drivers must not split
+        const bool is_eb = true;
+        EB2::SphereIF sphere(0.3, {AMREX_D_DECL(0.5,0.5,0.5)}, false);
+        EB2::Build(EB2::makeShop(sphere), geom, 0, 0);
+        auto factory = makeEBFabFactory(geom, grids, dmap, {6,6,6}, EBSupport::full);
+#else
+        const bool is_eb = false;
+        auto factory = std::make_unique<FArrayBoxFactory>();
+#endif
+
+        const Real dt = 0.4 / n_cell;
+
+        Vector<BCRec> h_bcrec(AMREX_SPACEDIM);
+        for (auto& bc : h_bcrec) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                const int t = geom.isPeriodic(idim) ? BCType::int_dir : BCType::foextrap;
+                bc.setLo(idim, t);
+                bc.setHi(idim, t);
+            }
+        }
+        Gpu::DeviceVector<BCRec> d_bcrec(h_bcrec.size());
+        Gpu::copy(Gpu::hostToDevice, h_bcrec.begin(), h_bcrec.end(), d_bcrec.begin());
+
+        Gpu::DeviceVector<int> iconserv(AMREX_SPACEDIM, 1);
+
+        for (std::string advection_type : advection_types)
+        {
+            amrex::Print() << "Advection type " << advection_type << std::endl;
+
+            const int ng_cell = 1 + amrex::max(
+                HydroUtils::nGrowRequired(advection_type, is_eb, "", HydroUtils::GhostField::State),
+                HydroUtils::nGrowRequired(advection_type, is_eb, "", HydroUtils::GhostField::Forcing),
+                HydroUtils::nGrowRequired(advection_type, is_eb, "", HydroUtils::GhostField::Divu));
+            const int ng_face = 1 +
+                HydroUtils::nGrowRequired(advection_type, is_eb, "", HydroUtils::GhostField::Velocity);
+
+            MultiFab vel(grids, dmap, AMREX_SPACEDIM, ng_cell, MFInfo(), *factory);
+            MultiFab vel_forces(grids, dmap, AMREX_SPACEDIM, ng_cell, MFInfo(), *factory);
+            MultiFab divu(grids, dmap, 1, ng_cell, MFInfo(), *factory);
+            init_data(vel, 0.0);
+            init_data(vel_forces, 2.0);
+            init_data(divu, 5.0);
+
+            Array<MultiFab,AMREX_SPACEDIM> umac, umac_ref, face, face_ref, flux, flux_ref;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                BoxArray const& ba = amrex::convert(grids, IntVect::TheDimensionVector(idim));
+                umac[idim].define(ba, dmap, 1, ng_face, MFInfo(), *factory);
+                umac[idim].setVal(1.e10);
+                umac_ref[idim].define(ba, dmap, 1, ng_face, MFInfo(), *factory);
+                umac_ref[idim].setVal(1.e10);
+                face[idim].define(ba, dmap, AMREX_SPACEDIM, 0, MFInfo(), *factory);
+                face_ref[idim].define(ba, dmap, AMREX_SPACEDIM, 0, MFInfo(), *factory);
+                flux[idim].define(ba, dmap, AMREX_SPACEDIM, 0, MFInfo(), *factory);
+                flux_ref[idim].define(ba, dmap, AMREX_SPACEDIM, 0, MFInfo(), *factory);
+            }
+
+            //
+            // Face velocities
+            //
+            MultiFab vel_ref = copy_of(vel);
+            MultiFab vel_forces_ref = copy_of(vel_forces);
+
+            vel_ref.FillBoundary(geom.periodicity());
+            vel_forces_ref.FillBoundary(geom.periodicity());
+            fill_physbc(vel_ref, geom);
+            fill_physbc(vel_forces_ref, geom);
+            HydroUtils::ExtrapVelToFaces(vel_ref, vel_forces_ref,
+                                         AMREX_D_DECL(umac_ref[0], umac_ref[1], umac_ref[2]),
+                                         h_bcrec, d_bcrec.data(), geom, dt,
+#ifdef AMREX_USE_EB
+                                         *factory, nullptr,
+#endif
+                                         false, true, advection_type);
+
+            HydroUtils::FillBoundaryAndExtrapVelToFaces(vel, vel_forces,
+                                                        AMREX_D_DECL(umac[0], umac[1], umac[2]),
+                                                        h_bcrec, d_bcrec.data(), geom, dt,
+#ifdef AMREX_USE_EB
+                                                        *factory, nullptr,
+#endif
+                                                        false, true, advection_type, nullptr,
+                                                        [&] () {
+                                                            fill_physbc(vel, geom);
+                                                            fill_physbc(vel_forces, geom);
+                                                        });
+
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                check_identical(umac[idim], umac_ref[idim], "umac " + std::to_string(idim));
+            }
+
+            //
+            // Edge states and fluxes of the velocity, advected by the face velocities
+            //
+            init_data(vel, 0.0);
+            init_data(vel_forces, 2.0);
+            MultiFab::Copy(vel_ref, vel, 0, 0, AMREX_SPACEDIM, ng_cell);
+            MultiFab::Copy(vel_forces_ref, vel_forces, 0, 0, AMREX_SPACEDIM, ng_cell);
+            MultiFab divu_ref = copy_of(divu);
+
+            vel_ref.FillBoundary(geom.periodicity());
+            vel_forces_ref.FillBoundary(geom.periodicity());
+            divu_ref.FillBoundary(geom.periodicity());
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                umac_ref[idim].FillBoundary(geom.periodicity());
+            }
+            fill_physbc(vel_ref, geom);
+            fill_physbc(vel_forces_ref, geom);
+            fill_physbc(divu_ref, geom);
+
+            for (MFIter mfi(vel_ref, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                HydroUtils::ComputeFluxesOnBoxFromState(mfi.tilebox(), AMREX_SPACEDIM, mfi,
+                                                        vel_ref.const_array(mfi),
+                                                        AMREX_D_DECL(flux_ref[0].array(mfi),
+                                                                     flux_ref[1].array(mfi),
+                                                                     flux_ref[2].array(mfi)),
+                                                        AMREX_D_DECL(face_ref[0].array(mfi),
+                                                                     face_ref[1].array(mfi),
+                                                                     face_ref[2].array(mfi)),
+                                                        /*knownFaceState*/ false,
+                                                        AMREX_D_DECL(umac_ref[0].const_array(mfi),
+                                                                     umac_ref[1].const_array(mfi),
+                                                                     umac_ref[2].const_array(mfi)),
+                                                        divu_ref.const_array(mfi),
+                                                        vel_forces_ref.const_array(mfi),
+                                                        geom, dt, h_bcrec, d_bcrec.data(),
+                                                        iconserv.data(),
+#ifdef AMREX_USE_EB
+                                                        *factory, Array4<Real const>{},
+#endif
+                                                        false, true, /*is_velocity*/ true,
+                                                        /*fluxes_are_area_weighted*/ false,
+                                                        advection_type);
+            }
+
+            HydroUtils::FillBoundaryAndComputeFluxes(vel, AMREX_SPACEDIM,
+                                                     AMREX_D_DECL(flux[0], flux[1], flux[2]),
+                                                     AMREX_D_DECL(face[0], face[1], face[2]),
+                                                     AMREX_D_DECL(umac[0], umac[1], umac[2]),
+                                                     &divu, &vel_forces,
+                                                     geom, dt, h_bcrec, d_bcrec.data(),
+                                                     iconserv.data(),
+#ifdef AMREX_USE_EB
+                                                     /*values_on_eb_inflow*/ nullptr,
+#endif
+                                                     false, true, /*is_velocity*/ true,
+                                                     /*fluxes_are_area_weighted*/ false,
+                                                     advection_type, nullptr,
+                                                     [&] () {
+                                                         fill_physbc(vel, geom);
+                                                         fill_physbc(vel_forces, geom);
+                                                         fill_physbc(divu, geom);
+                                                     });
+
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                check_identical(face[idim], face_ref[idim], "face state " + std::to_string(idim));
+                check_identical(flux[idim], flux_ref[idim], "flux " + std::to_string(idim));
+            }
+        }
+
+        amrex::Print() << " All results are bitwise identical" << std::endl;
+    }
+
+    amrex::Finalize();
+}
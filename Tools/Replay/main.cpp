@@ -0,0 +1,319 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <hydro_kernel_capture.H>
+#include <hydro_bds.H>
+#include <hydro_godunov.H>
+#include <hydro_mol.H>
+
+#ifdef AMREX_USE_EB
+#include <hydro_ebgodunov.H>
+#include <hydro_ebmol.H>
+#include <hydro_redistribution.H>
+#endif
+
+#include <functional>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+// Run kernel nrepeat times, calling setup before each run outside of the timer,
+// and print the fastest and mean wall-clock time.
+template <typename S, typename K>
+void
+RunAndTime (std::string const& name, int nrepeat, S const& setup, K const& kernel)
+{
+    // Warm up the arenas and, on the GPU, the kernel launches
+    setup();
+    kernel();
+    Gpu::streamSynchronize();
+
+    Real tmin = std::numeric_limits<Real>::max();
+    Real tsum = 0.0;
+    for (int r = 0; r < nrepeat; ++r)
+    {
+        setup();
+        Gpu::streamSynchronize();
+        Real t0 = amrex::second();
+        kernel();
+        Gpu::streamSynchronize();
+        Real t = amrex::second() - t0;
+        tmin = amrex::min(tmin, t);
+        tsum += t;
+    }
+
+    amrex::Print() << name << ": min " << tmin << " s, mean " << tsum/amrex::max(nrepeat,1)
+                   << " s over " << nrepeat << " runs\n";
+}
+
+// Largest difference between the replayed and the captured output on region
+void
+PrintDiff (std::string const& name, FArrayBox const& replayed, FArrayBox const& captured,
+           Box const& region)
+{
+    FArrayBox diff(captured.box(), captured.nComp());
+    diff.copy<RunOn::Device>(replayed);
+    diff.minus<RunOn::Device>(captured);
+
+    // The captured arrays are stored cell-centered with the index bounds of the
+    // original data, so compare on the cell box with the same bounds as region
+    const Box cbx = Box(region.smallEnd(), region.bigEnd()) & diff.box();
+
+    amrex::Print() << "  max |" << name << " - captured|:";
+    for (int n = 0; n < diff.nComp(); ++n) {
+        amrex::Print() << " " << diff.maxabs<RunOn::Device>(cbx, n);
+    }
+    amrex::Print() << "\n";
+}
+
+Array4<Real const>
+GetArray (HydroUtils::KernelArchive const& archive, std::string const& name, FArrayBox& fab)
+{
+    if (!archive.hasArray(name)) {
+        return Array4<Real const>{};
+    }
+    archive.getArray(name, fab);
+    return fab.const_array();
+}
+
+void
+ReplayEdgeState (HydroUtils::KernelArchive const& archive, int nrepeat)
+{
+    const std::string advection_type = archive.getString("advection_type");
+    const Box bx = archive.getBox("bx");
+    const int ncomp = archive.getInt("ncomp");
+    const Geometry geom = archive.getGeometry("geom");
+    const Real dt = archive.getReal("dt");
+    const bool use_ppm = archive.getInt("godunov_use_ppm");
+    const bool use_forces_in_trans = archive.getInt("godunov_use_forces_in_trans");
+    const bool is_velocity = archive.getInt("is_velocity");
+    const bool regular = archive.getInt("regular");
+
+    const Vector<BCRec> h_bcrec = archive.getBCRecs("bcrec");
+    Gpu::DeviceVector<BCRec> d_bcrec(h_bcrec.size());
+    Gpu::copy(Gpu::hostToDevice, h_bcrec.begin(), h_bcrec.end(), d_bcrec.begin());
+    const Gpu::DeviceVector<int> iconserv = archive.getInts("iconserv");
+
+    FArrayBox qfab, divufab, fqfab;
+    Array4<Real const> const& q    = GetArray(archive, "q", qfab);
+    Array4<Real const> const& divu = GetArray(archive, "divu", divufab);
+    Array4<Real const> const& fq   = GetArray(archive, "fq", fqfab);
+
+    Array<FArrayBox,AMREX_SPACEDIM> macfab;
+    AMREX_D_TERM(Array4<Real const> const& umac = GetArray(archive, "u_mac", macfab[0]);,
+                 Array4<Real const> const& vmac = GetArray(archive, "v_mac", macfab[1]);,
+                 Array4<Real const> const& wmac = GetArray(archive, "w_mac", macfab[2]););
+
+    const Array<std::string,AMREX_SPACEDIM> face_names{AMREX_D_DECL("face_x","face_y","face_z")};
+    Array<FArrayBox,AMREX_SPACEDIM> captured;
+    Array<FArrayBox,AMREX_SPACEDIM> edge;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        archive.getArray(face_names[d], captured[d]);
+        edge[d].resize(captured[d].box(), captured[d].nComp());
+        edge[d].setVal<RunOn::Device>(0.0);
+    }
+    AMREX_D_TERM(Array4<Real> const& xedge = edge[0].array();,
+                 Array4<Real> const& yedge = edge[1].array();,
+                 Array4<Real> const& zedge = edge[2].array(););
+
+    std::function<void()> kernel;
+
+#ifdef AMREX_USE_EB
+    FArrayBox vfracfab, ccentfab, valuesfab;
+    BaseFab<EBCellFlag> flagfab;
+    Array<FArrayBox,AMREX_SPACEDIM> areafab, fcentfab;
+    FArrayBox tmpfab;
+
+    if (!regular)
+    {
+        archive.getFlags("flag", flagfab);
+        Array4<EBCellFlag const> const& flag = flagfab.const_array();
+        Array4<Real const> const& vfrac  = GetArray(archive, "vfrac", vfracfab);
+        Array4<Real const> const& ccent  = GetArray(archive, "ccent", ccentfab);
+        Array4<Real const> const& values = GetArray(archive, "values_on_eb_inflow", valuesfab);
+        AMREX_D_TERM(Array4<Real const> const& apx = GetArray(archive, "area0", areafab[0]);,
+                     Array4<Real const> const& apy = GetArray(archive, "area1", areafab[1]);,
+                     Array4<Real const> const& apz = GetArray(archive, "area2", areafab[2]););
+        AMREX_D_TERM(Array4<Real const> const& fcx = GetArray(archive, "fcent0", fcentfab[0]);,
+                     Array4<Real const> const& fcy = GetArray(archive, "fcent1", fcentfab[1]);,
+                     Array4<Real const> const& fcz = GetArray(archive, "fcent2", fcentfab[2]););
+
+        if (advection_type == "MOL")
+        {
+            kernel = [&, flag, vfrac, ccent, AMREX_D_DECL(fcx,fcy,fcz)] () {
+                EBMOL::ComputeEdgeState(bx, AMREX_D_DECL(xedge,yedge,zedge), q, ncomp,
+                                        AMREX_D_DECL(umac,vmac,wmac),
+                                        geom.Domain(), h_bcrec, d_bcrec.data(),
+                                        AMREX_D_DECL(fcx,fcy,fcz), ccent, vfrac, flag,
+                                        is_velocity);
+            };
+        }
+        else if (advection_type == "Godunov")
+        {
+            tmpfab.resize(amrex::grow(bx,4), (4*AMREX_SPACEDIM + 2)*ncomp);
+            kernel = [&, flag, vfrac, ccent, values, AMREX_D_DECL(apx,apy,apz), AMREX_D_DECL(fcx,fcy,fcz)] () {
+                EBGodunov::ComputeEdgeState(bx, ncomp, q, AMREX_D_DECL(xedge,yedge,zedge),
+                                            AMREX_D_DECL(umac,vmac,wmac), divu, fq,
+                                            geom, dt, h_bcrec, d_bcrec.data(), iconserv.data(),
+                                            tmpfab.dataPtr(), flag,
+                                            AMREX_D_DECL(apx,apy,apz), vfrac,
+                                            AMREX_D_DECL(fcx,fcy,fcz), ccent,
+                                            is_velocity, values);
+            };
+        }
+    }
+    else
+#endif
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(regular,
+                                         "Replaying an EB capture requires a build with USE_EB = TRUE");
+
+        if (advection_type == "MOL")
+        {
+            kernel = [&] () {
+                MOL::ComputeEdgeState(bx, AMREX_D_DECL(xedge,yedge,zedge), q, ncomp,
+                                      AMREX_D_DECL(umac,vmac,wmac),
+                                      geom.Domain(), h_bcrec, d_bcrec.data(), is_velocity);
+            };
+        }
+        else if (advection_type == "Godunov")
+        {
+            kernel = [&] () {
+                Godunov::ComputeEdgeState(bx, ncomp, q, AMREX_D_DECL(xedge,yedge,zedge),
+                                          AMREX_D_DECL(umac,vmac,wmac), divu, fq,
+                                          geom, dt, d_bcrec.data(), iconserv.data(),
+                                          use_ppm, is_velocity, use_forces_in_trans);
+            };
+        }
+        else if (advection_type == "BDS")
+        {
+            kernel = [&] () {
+                BDS::ComputeEdgeState(bx, ncomp, q, AMREX_D_DECL(xedge,yedge,zedge),
+                                      AMREX_D_DECL(umac,vmac,wmac), divu, fq,
+                                      geom, dt, d_bcrec.data(), iconserv.data(),
+                                      is_velocity);
+            };
+        }
+    }
+
+    if (!kernel) {
+        amrex::Abort("Cannot replay ComputeEdgeState with advection_type "+advection_type);
+    }
+
+    amrex::Print() << "Replaying ComputeEdgeState (" << advection_type
+                   << (regular ? "" : ", EB") << ") on " << bx << "\n";
+
+    RunAndTime("ComputeEdgeState", nrepeat, [] () {}, kernel);
+
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        PrintDiff(face_names[d], edge[d], captured[d], amrex::surroundingNodes(bx,d));
+    }
+}
+
+#ifdef AMREX_USE_EB
+void
+ReplayRedistribution (HydroUtils::KernelArchive const& archive, int nrepeat)
+{
+    const std::string redistribution_type = archive.getString("redistribution_type");
+    const Box bx = archive.getBox("bx");
+    const int ncomp = archive.getInt("ncomp");
+    const Geometry geom = archive.getGeometry("geom");
+    const Real dt = archive.getReal("dt");
+    const int srd_max_order = archive.getInt("srd_max_order");
+    const Real target_volfrac = archive.getReal("target_volfrac");
+
+    const Vector<BCRec> h_bcrec = archive.getBCRecs("bcrec");
+    Gpu::DeviceVector<BCRec> d_bcrec(h_bcrec.size());
+    Gpu::copy(Gpu::hostToDevice, h_bcrec.begin(), h_bcrec.end(), d_bcrec.begin());
+
+    FArrayBox dUdt_in_captured, dUdt_in, U_infab, vfracfab, ccentfab, scalefab;
+    archive.getArray("dUdt_in", dUdt_in_captured);
+    dUdt_in.resize(dUdt_in_captured.box(), ncomp);
+    Array4<Real const> const& U_in  = GetArray(archive, "U_in", U_infab);
+    Array4<Real const> const& vfrac = GetArray(archive, "vfrac", vfracfab);
+    Array4<Real const> const& ccent = GetArray(archive, "ccent", ccentfab);
+    Array4<Real const> const& scale = GetArray(archive, "update_scale", scalefab);
+
+    BaseFab<EBCellFlag> flagfab;
+    archive.getFlags("flag", flagfab);
+
+    Array<FArrayBox,AMREX_SPACEDIM> areafab, fcentfab;
+    AMREX_D_TERM(Array4<Real const> const& apx = GetArray(archive, "area0", areafab[0]);,
+                 Array4<Real const> const& apy = GetArray(archive, "area1", areafab[1]);,
+                 Array4<Real const> const& apz = GetArray(archive, "area2", areafab[2]););
+    AMREX_D_TERM(Array4<Real const> const& fcx = GetArray(archive, "fcent0", fcentfab[0]);,
+                 Array4<Real const> const& fcy = GetArray(archive, "fcent1", fcentfab[1]);,
+                 Array4<Real const> const& fcz = GetArray(archive, "fcent2", fcentfab[2]););
+
+    FArrayBox captured, dUdt_out;
+    archive.getArray("dUdt_out", captured);
+    dUdt_out.resize(captured.box(), ncomp);
+    dUdt_out.setVal<RunOn::Device>(0.0);
+
+    FArrayBox scratch(archive.getBox("scratch_box"), ncomp);
+
+    // Apply may overwrite dUdt_in and scratch, so start every run from the captured state
+    auto setup = [&] () {
+        dUdt_in.copy<RunOn::Device>(dUdt_in_captured);
+        if (redistribution_type == "FluxRedist") {
+            scratch.setVal<RunOn::Device>(1.0);
+        }
+    };
+
+    auto kernel = [&] () {
+        Redistribution::Apply(bx, ncomp, dUdt_out.array(), dUdt_in.array(), U_in,
+                              scratch.array(), flagfab.const_array(),
+                              AMREX_D_DECL(apx,apy,apz), vfrac,
+                              AMREX_D_DECL(fcx,fcy,fcz), ccent,
+                              d_bcrec.data(), geom, dt, redistribution_type,
+                              srd_max_order, target_volfrac, scale);
+    };
+
+    amrex::Print() << "Replaying Redistribution::Apply (" << redistribution_type
+                   << ") on " << bx << "\n";
+
+    RunAndTime("Redistribution::Apply", nrepeat, setup, kernel);
+
+    PrintDiff("dUdt_out", dUdt_out, captured, bx);
+}
+#endif
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        std::string file;
+        int nrepeat = 10;
+        {
+            ParmParse pp("replay");
+            pp.get("file", file);
+            pp.query("nrepeat", nrepeat);
+        }
+
+        HydroUtils::KernelArchive archive;
+        archive.read(file);
+
+        if (archive.kernel() == "ComputeEdgeState")
+        {
+            ReplayEdgeState(archive, nrepeat);
+        }
+#ifdef AMREX_USE_EB
+        else if (archive.kernel() == "Redistribution::Apply")
+        {
+            ReplayRedistribution(archive, nrepeat);
+        }
+#endif
+        else
+        {
+            amrex::Abort("Don't know how to replay kernel "+archive.kernel());
+        }
+    }
+
+    amrex::Finalize();
+}
@@ -6,12 +6,15 @@
 #include <hydro_bds.H>
 #include <hydro_mol.H>
 #include <hydro_utils.H>
+#include <hydro_kernel_capture.H>
 
 #ifdef AMREX_USE_EB
 #include <hydro_ebgodunov.H>
 #include <hydro_ebmol.H>
 #endif
 
+#include <utility>
+
 using namespace amrex;
 
 namespace {
@@ -133,6 +136,145 @@ namespace {
             }
         }
     }
+
+    HydroUtils::KernelArchive
+    CaptureEdgeStateInputs (Box const& bx, int ncomp, MFIter const& mfi,
+                            Array4<Real const> const& q,
+                            AMREX_D_DECL(Array4<Real const> const& u_mac,
+                                         Array4<Real const> const& v_mac,
+                                         Array4<Real const> const& w_mac),
+                            Array4<Real const> const& divu,
+                            Array4<Real const> const& fq,
+                            Geometry const& geom, Real l_dt,
+                            const BCRec* d_bcrec,
+                            int const* iconserv,
+#ifdef AMREX_USE_EB
+                            const EBFArrayBoxFactory& ebfact,
+                            Array4<Real const> const& values_on_eb_inflow,
+                            bool regular,
+#endif
+                            bool godunov_use_ppm, bool godunov_use_forces_in_trans,
+                            bool is_velocity,
+                            std::string const& advection_type)
+    {
+        HydroUtils::KernelArchive archive("ComputeEdgeState");
+        archive.addString("advection_type", advection_type);
+        archive.addBox("bx", bx);
+        archive.addInt("ncomp", ncomp);
+        archive.addArray("q", q);
+        AMREX_D_TERM(archive.addArray("u_mac", u_mac);,
+                     archive.addArray("v_mac", v_mac);,
+                     archive.addArray("w_mac", w_mac););
+        archive.addArray("divu", divu);
+        archive.addArray("fq", fq);
+        archive.addGeometry("geom", geom);
+        archive.addReal("dt", l_dt);
+        archive.addBCRecs("bcrec", d_bcrec, ncomp);
+        archive.addInts("iconserv", iconserv, ncomp);
+        archive.addInt("godunov_use_ppm", godunov_use_ppm);
+        archive.addInt("godunov_use_forces_in_trans", godunov_use_forces_in_trans);
+        archive.addInt("is_velocity", is_velocity);
+#ifdef AMREX_USE_EB
+        archive.addInt("regular", regular);
+        if (!regular)
+        {
+            archive.addFlags("flag", ebfact.getMultiEBCellFlagFab().const_array(mfi));
+            archive.addArray("vfrac", ebfact.getVolFrac().const_array(mfi));
+            archive.addArray("ccent", ebfact.getCentroid().const_array(mfi));
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                archive.addArray("area"+std::to_string(d), ebfact.getAreaFrac()[d]->const_array(mfi));
+                archive.addArray("fcent"+std::to_string(d), ebfact.getFaceCent()[d]->const_array(mfi));
+            }
+            archive.addArray("values_on_eb_inflow", values_on_eb_inflow);
+        }
+#else
+        archive.addInt("regular", 1);
+#endif
+        return archive;
+    }
+
+    void
+    AddToFluxRegisters (Box const& bx, int ncomp, MFIter const& mfi,
+                        AMREX_D_DECL(Array4<Real> const& flux_x,
+                                     Array4<Real> const& flux_y,
+                                     Array4<Real> const& flux_z),
+                        Geometry const& geom, bool fluxes_are_area_weighted,
+#ifdef AMREX_USE_EB
+                        EBFArrayBoxFactory const& ebfact,
+#endif
+                        HydroUtils::FluxRegisterSink const& sink)
+    {
+        // The registers add the fluxes on all the faces of the tile, so these
+        // must all have been computed
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(bx == mfi.tilebox(),
+            "HydroUtils::ComputeFluxesOnBoxFromState: flux registers need bx to be the tile box");
+
+        // The registers scale the fluxes by dt/dx. Area weighted fluxes have
+        // already been multiplied by the face area, so hand them the cell
+        // volume instead to end up with the same dt*area/volume.
+        GpuArray<Real,AMREX_SPACEDIM> dx = geom.CellSizeArray();
+        if (fluxes_are_area_weighted) {
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!geom.IsRZ(),
+                "HydroUtils::ComputeFluxesOnBoxFromState: flux registers do not support area weighted fluxes in RZ");
+            const Real vol = AMREX_D_TERM(dx[0],*dx[1],*dx[2]);
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                dx[dir] = vol;
+            }
+        }
+
+        AMREX_D_TERM( FArrayBox fxfab(flux_x, IndexType::TheDimensionVector(0));,
+                      FArrayBox fyfab(flux_y, IndexType::TheDimensionVector(1));,
+                      FArrayBox fzfab(flux_z, IndexType::TheDimensionVector(2)););
+        const std::array<FArrayBox const*,AMREX_SPACEDIM> fluxes{AMREX_D_DECL(&fxfab,&fyfab,&fzfab)};
+
+        const RunOn runon = Gpu::inLaunchRegion() ? RunOn::Gpu : RunOn::Cpu;
+
+#ifdef AMREX_USE_EB
+        if (ebfact.getMultiEBCellFlagFab()[mfi].getType(amrex::grow(bx,1)) != FabType::regular)
+        {
+            // The EB interface multiplies the fluxes by the area fractions it is
+            // given, which the fluxes computed here already include, so it gets
+            // unit ones. Its volume fraction weighting is what the plain
+            // interface lacks.
+            AMREX_D_TERM( FArrayBox apxfab(Box(flux_x), 1, The_Async_Arena());,
+                          FArrayBox apyfab(Box(flux_y), 1, The_Async_Arena());,
+                          FArrayBox apzfab(Box(flux_z), 1, The_Async_Arena()););
+            AMREX_D_TERM( apxfab.setVal<RunOn::Device>(1.0);,
+                          apyfab.setVal<RunOn::Device>(1.0);,
+                          apzfab.setVal<RunOn::Device>(1.0););
+            const std::array<FArrayBox const*,AMREX_SPACEDIM> areafrac{AMREX_D_DECL(&apxfab,&apyfab,&apzfab)};
+            FArrayBox const& volfrac = ebfact.getVolFrac()[mfi];
+
+            if (sink.crse) {
+                sink.crse->CrseAdd(mfi, fluxes, dx.data(), sink.dt, volfrac, areafrac,
+                                   0, sink.dcomp, ncomp, runon);
+            }
+            if (sink.fine) {
+                // Wide enough for the fine cells of the coarse cells around the
+                // tile, for refinement ratios up to 4
+                FArrayBox dm(amrex::grow(bx,4), ncomp, The_Async_Arena());
+                dm.setVal<RunOn::Device>(0.0);
+                sink.fine->FineAdd(mfi, fluxes, dx.data(), sink.dt, volfrac, areafrac, dm,
+                                   0, sink.dcomp, ncomp, runon);
+            }
+            return;
+        }
+
+        if (sink.crse) {
+            sink.crse->YAFluxRegister::CrseAdd(mfi, fluxes, dx.data(), sink.dt, 0, sink.dcomp, ncomp, runon);
+        }
+        if (sink.fine) {
+            sink.fine->YAFluxRegister::FineAdd(mfi, fluxes, dx.data(), sink.dt, 0, sink.dcomp, ncomp, runon);
+        }
+#else
+        if (sink.crse) {
+            sink.crse->CrseAdd(mfi, fluxes, dx.data(), sink.dt, 0, sink.dcomp, ncomp, runon);
+        }
+        if (sink.fine) {
+            sink.fine->FineAdd(mfi, fluxes, dx.data(), sink.dt, 0, sink.dcomp, ncomp, runon);
+        }
+#endif
+    }
 }
 
 #ifdef AMREX_USE_EB
@@ -158,7 +300,8 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
                                          const EBFArrayBoxFactory& ebfact,
                                          bool godunov_use_ppm, bool godunov_use_forces_in_trans,
                                          bool is_velocity, bool fluxes_are_area_weighted,
-                                         std::string& advection_type)
+                                         std::string& advection_type,
+                                         FluxRegisterSink const* flux_register)
 
 {
     ComputeFluxesOnBoxFromState(bx, ncomp, mfi, q,
@@ -169,7 +312,8 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
                                 divu, fq, geom, l_dt, h_bcrec, d_bcrec, iconserv,
                                 ebfact, /*values_on_eb_inflow*/ Array4<Real const>{},
                                 godunov_use_ppm, godunov_use_forces_in_trans,
-                                is_velocity, fluxes_are_area_weighted, advection_type);
+                                is_velocity, fluxes_are_area_weighted, advection_type,
+                                flux_register);
 
 }
 #endif
@@ -200,7 +344,8 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
 #endif
                                          bool godunov_use_ppm, bool godunov_use_forces_in_trans,
                                          bool is_velocity, bool fluxes_are_area_weighted,
-                                         std::string& advection_type)
+                                         std::string& advection_type,
+                                         FluxRegisterSink const* flux_register)
 
 {
     ComputeFluxesOnBoxFromState(bx, ncomp, mfi, q,
@@ -214,7 +359,8 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
                                 ebfact, values_on_eb_inflow,
 #endif
                                 godunov_use_ppm, godunov_use_forces_in_trans,
-                                is_velocity, fluxes_are_area_weighted, advection_type);
+                                is_velocity, fluxes_are_area_weighted, advection_type,
+                                flux_register);
 
 }
 
@@ -246,7 +392,8 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
 #endif
                                          bool godunov_use_ppm, bool godunov_use_forces_in_trans,
                                          bool is_velocity, bool fluxes_are_area_weighted,
-                                         std::string& advection_type)
+                                         std::string& advection_type,
+                                         FluxRegisterSink const* flux_register)
 
 {
 #ifdef AMREX_USE_EB
@@ -257,12 +404,27 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
     if (flagfab.getType(bx) == FabType::covered)
         return;
 
-    //FIXME? -- Godunov needs to check on grow 3, but MOL only needs 2
-    bool regular = (flagfab.getType(amrex::grow(bx,3)) == FabType::regular);
+    // The regular scheme can be used if its whole stencil is regular
+    const int nghost_regular = nGrowRequired(advection_type, false, "", GhostField::State);
+    bool regular = (flagfab.getType(amrex::grow(bx,nghost_regular)) == FabType::regular);
 #endif
 
     // Compute edge state if needed
     if (!knownFaceState) {
+        // Save the inputs and outputs of this call if asked to by hydro.capture_box
+        const bool capture = CaptureRequested("ComputeEdgeState", mfi.index());
+        KernelArchive archive;
+        if (capture) {
+            archive = CaptureEdgeStateInputs(bx, ncomp, mfi, q,
+                                             AMREX_D_DECL(u_mac,v_mac,w_mac),
+                                             divu, fq, geom, l_dt, d_bcrec, iconserv,
+#ifdef AMREX_USE_EB
+                                             ebfact, values_on_eb_inflow, regular,
+#endif
+                                             godunov_use_ppm, godunov_use_forces_in_trans,
+                                             is_velocity, advection_type);
+        }
+
         ComputeEdgeState(bx, ncomp, mfi, q,
                          AMREX_D_DECL(face_x,face_y,face_z),
                          AMREX_D_DECL(u_mac,v_mac,w_mac),
@@ -274,6 +436,13 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
 #endif
                          godunov_use_ppm, godunov_use_forces_in_trans,
                          is_velocity, advection_type);
+
+        if (capture) {
+            AMREX_D_TERM(archive.addArray("face_x", face_x);,
+                         archive.addArray("face_y", face_y);,
+                         archive.addArray("face_z", face_z););
+            WriteCapture(archive, mfi.index());
+        }
     }
 
     // Compute fluxes.
@@ -301,6 +470,166 @@ HydroUtils::ComputeFluxesOnBoxFromState (Box const& bx, int ncomp, MFIter& mfi,
                                    AMREX_D_DECL(face_x,face_y,face_z),
                                    geom, ncomp, fluxes_are_area_weighted );
     }
+
+    if (flux_register) {
+        AddToFluxRegisters(bx, ncomp, mfi, AMREX_D_DECL(flux_x,flux_y,flux_z),
+                           geom, fluxes_are_area_weighted,
+#ifdef AMREX_USE_EB
+                           ebfact,
+#endif
+                           *flux_register);
+    }
+}
+
+void
+HydroUtils::FillBoundaryAndComputeFluxes (MultiFab& q, int ncomp,
+                                          AMREX_D_DECL(MultiFab& flux_x,
+                                                       MultiFab& flux_y,
+                                                       MultiFab& flux_z),
+                                          AMREX_D_DECL(MultiFab& face_x,
+                                                       MultiFab& face_y,
+                                                       MultiFab& face_z),
+                                          AMREX_D_DECL(MultiFab& umac,
+                                                       MultiFab& vmac,
+                                                       MultiFab& wmac),
+                                          MultiFab* divu,
+                                          MultiFab* fq,
+                                          Geometry const& geom, Real l_dt,
+                                          Vector<BCRec> const& h_bcrec,
+                                          const BCRec* d_bcrec,
+                                          int const* iconserv,
+#ifdef AMREX_USE_EB
+                                          MultiFab const* values_on_eb_inflow,
+#endif
+                                          bool godunov_use_ppm, bool godunov_use_forces_in_trans,
+                                          bool is_velocity, bool fluxes_are_area_weighted,
+                                          std::string& advection_type,
+                                          FluxRegisterSink const* flux_register,
+                                          PhysBCFill const& fill_physbc)
+{
+    BL_PROFILE("HydroUtils::FillBoundaryAndComputeFluxes");
+
+#ifdef AMREX_USE_EB
+    AMREX_ALWAYS_ASSERT(q.hasEBFabFactory());
+    auto const& ebfact = dynamic_cast<EBFArrayBoxFactory const&>(q.Factory());
+    const bool regular = ebfact.isAllRegular();
+#else
+    const bool regular = true;
+#endif
+
+    // Cells read beyond a box when computing the edge states and fluxes on its faces
+    const int nghost = nGrowRequired(advection_type, !regular, "", GhostField::State);
+#ifdef AMREX_USE_EB
+    // Width around a box that must be regular for the regular scheme to be used on it
+    const int nghost_regular = nGrowRequired(advection_type, false, "", GhostField::State);
+#endif
+
+    // Only exchange the ghost cells that are actually read
+    Vector<std::pair<MultiFab*,int>> fill;
+    fill.emplace_back(&q, nghost);
+    const int nghost_face = nGrowRequired(advection_type, !regular, "", GhostField::Velocity);
+    AMREX_D_TERM( fill.emplace_back(&umac, nghost_face);,
+                  fill.emplace_back(&vmac, nghost_face);,
+                  fill.emplace_back(&wmac, nghost_face););
+    if (divu) { fill.emplace_back(divu, nGrowRequired(advection_type, !regular, "", GhostField::Divu)); }
+    if (fq)   { fill.emplace_back(fq, nGrowRequired(advection_type, !regular, "", GhostField::Forcing)); }
+
+    for (auto& f : fill) {
+        MultiFab* mf = f.first;
+        f.second = amrex::min(f.second, mf->nGrow());
+        if (f.second > 0) {
+            const int nc = (mf == &q) ? ncomp : mf->nComp();
+            mf->FillBoundary_nowait(0, nc, IntVect(f.second), geom.periodicity());
+        }
+    }
+
+    // On GPUs the tile is the whole box and the Halo region would be up to
+    // 2*AMREX_SPACEDIM thin slabs, each a separate launch, so do not overlap there
+    const Vector<TileRegion> regions = Gpu::inLaunchRegion()
+        ? Vector<TileRegion>{TileRegion::All}
+        : Vector<TileRegion>{TileRegion::Interior, TileRegion::Halo};
+
+    for (auto region : regions)
+    {
+        if (region != TileRegion::Interior) {
+            // Time left waiting for the exchange, plus the physical boundaries
+            BL_PROFILE_VAR("HydroUtils::FillBoundaryAndComputeFluxes::finish", fb_finish);
+            for (auto const& f : fill) {
+                if (f.second > 0) {
+                    f.first->FillBoundary_finish();
+                }
+            }
+            if (fill_physbc) {
+                fill_physbc();
+            }
+            BL_PROFILE_VAR_STOP(fb_finish);
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(q, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            AMREX_D_TERM( Array4<Real> const& fx = flux_x.array(mfi);,
+                          Array4<Real> const& fy = flux_y.array(mfi);,
+                          Array4<Real> const& fz = flux_z.array(mfi););
+
+            AMREX_D_TERM( Array4<Real> const& xed = face_x.array(mfi);,
+                          Array4<Real> const& yed = face_y.array(mfi);,
+                          Array4<Real> const& zed = face_z.array(mfi););
+
+            AMREX_D_TERM( Array4<Real const> const& u = umac.const_array(mfi);,
+                          Array4<Real const> const& v = vmac.const_array(mfi);,
+                          Array4<Real const> const& w = wmac.const_array(mfi););
+
+            Array4<Real const> const& qarr = q.const_array(mfi);
+            Array4<Real const> const& divu_arr = divu ? divu->const_array(mfi) : Array4<Real const>{};
+            Array4<Real const> const& fq_arr   = fq   ? fq->const_array(mfi)   : Array4<Real const>{};
+
+#ifdef AMREX_USE_EB
+            // ComputeFluxesOnBoxFromState picks the regular scheme by the box it is
+            // given, so only split tiles where it would pick it for the whole tile
+            const bool split = (ebfact.getMultiEBCellFlagFab()[mfi].getType(
+                                    amrex::grow(mfi.tilebox(), nghost_regular)) == FabType::regular);
+#else
+            const bool split = true;
+#endif
+
+            for (Box const& bx : TileRegionBoxes(mfi, region, nghost, split))
+            {
+                ComputeFluxesOnBoxFromState(bx, ncomp, mfi, qarr,
+                                            AMREX_D_DECL(fx, fy, fz),
+                                            AMREX_D_DECL(xed, yed, zed),
+                                            /*knownFaceState*/ false,
+                                            AMREX_D_DECL(u, v, w),
+                                            divu_arr, fq_arr, geom, l_dt,
+                                            h_bcrec, d_bcrec, iconserv,
+#ifdef AMREX_USE_EB
+                                            ebfact,
+                                            values_on_eb_inflow ?
+                                               values_on_eb_inflow->const_array(mfi) : Array4<Real const>{},
+#endif
+                                            godunov_use_ppm, godunov_use_forces_in_trans,
+                                            is_velocity, fluxes_are_area_weighted, advection_type);
+            }
+
+            // The registers work on whole tiles, which are only complete after the last pass
+            if (flux_register && region != TileRegion::Interior)
+            {
+#ifdef AMREX_USE_EB
+                if (ebfact.getMultiEBCellFlagFab()[mfi].getType(mfi.tilebox()) == FabType::covered) {
+                    continue;
+                }
+#endif
+                AddToFluxRegisters(mfi.tilebox(), ncomp, mfi, AMREX_D_DECL(fx, fy, fz),
+                                   geom, fluxes_are_area_weighted,
+#ifdef AMREX_USE_EB
+                                   ebfact,
+#endif
+                                   *flux_register);
+            }
+        }
+    }
 }
 
 /** @}*/
@@ -0,0 +1,505 @@
+/** \addtogroup Utilities
+ * @{
+ */
+
+#include <hydro_utils.H>
+
+#ifdef AMREX_USE_EB
+#include <hydro_godunov.H>
+#include <hydro_mol.H>
+#include <hydro_ebgodunov.H>
+#include <hydro_ebmol.H>
+#include <hydro_redistribution.H>
+
+#include <AMReX_ParallelDescriptor.H>
+
+#include <cmath>
+#include <limits>
+#include <map>
+
+using namespace amrex;
+
+namespace {
+
+    // Limit this function to this file
+    template <typename F>
+    Real
+    TimeKernel (F const& f)
+    {
+        constexpr int nrepeat = 3;
+
+        // First call warms up the arenas and, on the GPU, the kernel launches
+        f();
+        Gpu::streamSynchronize();
+
+        Real tmin = std::numeric_limits<Real>::max();
+        for (int r = 0; r < nrepeat; ++r)
+        {
+            Real t0 = amrex::second();
+            f();
+            Gpu::streamSynchronize();
+            tmin = amrex::min(tmin, amrex::second() - t0);
+        }
+        return tmin;
+    }
+
+    // Limit this struct to this file
+    //
+    // EB geometric data on a box cut by a plane, with the volume and area
+    // fractions and centroids estimated by sampling each cell and face. The
+    // fluid is on the side of the plane n.x > c, with x in units of cells. If
+    // plates is set, the fluid is instead where the fractional part of x is
+    // above c, i.e. a stack of thin plates normal to x that makes every cell
+    // a small cut cell.
+    struct PlaneEB
+    {
+        PlaneEB (Box const& gbx, GpuArray<Real,AMREX_SPACEDIM> const& n, Real c, bool plates)
+            : flagfab(gbx), vfrac(gbx, 1), ccent(gbx, AMREX_SPACEDIM)
+        {
+            constexpr int nsub = 8;
+
+            auto is_fluid = [=] AMREX_GPU_DEVICE (GpuArray<Real,AMREX_SPACEDIM> const& x) noexcept
+            {
+                if (plates) {
+                    return x[0] - std::floor(x[0]) > c;
+                }
+                Real d = 0.0;
+                for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) { d += n[dir]*x[dir]; }
+                return d > c;
+            };
+
+            Array4<Real> const& vf = vfrac.array();
+            Array4<Real> const& cc = ccent.array();
+            amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                int nfluid = 0;
+                GpuArray<Real,AMREX_SPACEDIM> csum{AMREX_D_DECL(0.,0.,0.)};
+                for (int s = 0; s < AMREX_D_TERM(nsub,*nsub,*nsub); ++s)
+                {
+                    GpuArray<Real,AMREX_SPACEDIM> x;
+                    GpuArray<Real,AMREX_SPACEDIM> off;
+                    int r = s;
+                    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                        off[dir] = (r%nsub + Real(0.5))/nsub - Real(0.5);
+                        x[dir] = iv[dir] + Real(0.5) + off[dir];
+                        r /= nsub;
+                    }
+                    if (is_fluid(x)) {
+                        ++nfluid;
+                        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) { csum[dir] += off[dir]; }
+                    }
+                }
+                vf(i,j,k) = Real(nfluid) / Real(AMREX_D_TERM(nsub,*nsub,*nsub));
+                for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                    cc(i,j,k,dir) = (nfluid > 0) ? csum[dir]/nfluid : Real(0.0);
+                }
+            });
+
+            for (int d = 0; d < AMREX_SPACEDIM; ++d)
+            {
+                const Box& fbx = amrex::surroundingNodes(gbx,d);
+                area[d].resize(fbx, 1);
+                fcent[d].resize(fbx, AMREX_SPACEDIM-1);
+                Array4<Real> const& ap = area[d].array();
+                Array4<Real> const& fc = fcent[d].array();
+                amrex::ParallelFor(fbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+                {
+                    const IntVect iv(AMREX_D_DECL(i,j,k));
+                    int nfluid = 0;
+                    GpuArray<Real,AMREX_SPACEDIM> csum{AMREX_D_DECL(0.,0.,0.)};
+                    for (int s = 0; s < AMREX_D_TERM(1,*nsub,*nsub); ++s)
+                    {
+                        GpuArray<Real,AMREX_SPACEDIM> x;
+                        GpuArray<Real,AMREX_SPACEDIM> off;
+                        int r = s;
+                        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                            if (dir == d) {
+                                off[dir] = 0.0;
+                                x[dir] = iv[dir];
+                            } else {
+                                off[dir] = (r%nsub + Real(0.5))/nsub - Real(0.5);
+                                x[dir] = iv[dir] + Real(0.5) + off[dir];
+                                r /= nsub;
+                            }
+                        }
+                        if (is_fluid(x)) {
+                            ++nfluid;
+                            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) { csum[dir] += off[dir]; }
+                        }
+                    }
+                    ap(i,j,k) = Real(nfluid) / Real(AMREX_D_TERM(1,*nsub,*nsub));
+                    for (int dir = 0, t = 0; dir < AMREX_SPACEDIM; ++dir) {
+                        if (dir != d) {
+                            fc(i,j,k,t++) = (nfluid > 0) ? csum[dir]/nfluid : Real(0.0);
+                        }
+                    }
+                });
+            }
+
+            // A cell is regular if it and all its faces are fully open, covered
+            // if it has no fluid, and cut otherwise. Neighbors are connected
+            // unless either is covered or, across a face, the face is closed.
+            Array4<EBCellFlag> const& flag = flagfab.array();
+            AMREX_D_TERM(Array4<Real const> const& apx = area[0].const_array();,
+                         Array4<Real const> const& apy = area[1].const_array();,
+                         Array4<Real const> const& apz = area[2].const_array(););
+            amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                const GpuArray<Array4<Real const>,AMREX_SPACEDIM> ap{AMREX_D_DECL(apx,apy,apz)};
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+
+                EBCellFlag f = EBCellFlag::TheDefaultCell();
+                if (vf(iv) == 0.0) {
+                    f.setCovered();
+                    f.setDisconnected();
+                    flag(iv) = f;
+                    return;
+                }
+
+                bool all_open = (vf(iv) == 1.0);
+                for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                    all_open = all_open && ap[dir](iv) == 1.0
+                                        && ap[dir](iv+IntVect::TheDimensionVector(dir)) == 1.0;
+                }
+                if (!all_open) {
+                    f.setSingleValued();
+                }
+
+                for (int s = 0; s < AMREX_D_TERM(3,*3,*3); ++s)
+                {
+                    IntVect offset;
+                    int r = s;
+                    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                        offset[dir] = r%3 - 1;
+                        r /= 3;
+                    }
+                    const IntVect nb = iv + offset;
+                    if (offset == IntVect::TheZeroVector() || !gbx.contains(nb)) {
+                        continue;
+                    }
+
+                    int nnonzero = 0;
+                    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                        if (offset[dir] != 0) { ++nnonzero; }
+                    }
+                    bool connected = (vf(nb) > 0.0);
+                    if (connected && nnonzero == 1) {
+                        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                            if (offset[dir] != 0) {
+                                connected = ap[dir](offset[dir] > 0 ? nb : iv) > 0.0;
+                            }
+                        }
+                    }
+                    if (!connected) {
+                        f.setDisconnected(offset);
+                    }
+                }
+                flag(iv) = f;
+            });
+        }
+
+        EBCellFlagFab flagfab;
+        FArrayBox vfrac;
+        FArrayBox ccent;
+        Array<FArrayBox,AMREX_SPACEDIM> area;
+        Array<FArrayBox,AMREX_SPACEDIM> fcent;
+    };
+
+    // Limit this function to this file
+    //
+    // Number of cut cells with a volume fraction below 1/2
+    Real
+    CountSmallCells (PlaneEB const& eb, Box const& bx)
+    {
+        FArrayBox small(bx, 1);
+        Array4<Real> const& sm = small.array();
+        Array4<Real const> const& vf = eb.vfrac.const_array();
+        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            sm(i,j,k) = (vf(i,j,k) > 0.0 && vf(i,j,k) < 0.5) ? 1.0 : 0.0;
+        });
+        return small.sum<RunOn::Device>(bx, 0, 1);
+    }
+}
+
+HydroUtils::BoxCostModel
+HydroUtils::CalibrateBoxCost ( std::string const& advection_type, int ncomp,
+                               std::string const& redistribution_type )
+{
+    static std::map<std::string,BoxCostModel> cache;
+
+    const std::string key = advection_type + ":" + std::to_string(ncomp) + ":" + redistribution_type;
+    auto found = cache.find(key);
+    if (found != cache.end()) {
+        return found->second;
+    }
+
+    if (advection_type == "BDS") {
+        amrex::Abort("HydroUtils::CalibrateBoxCost: BDS is not available with EB");
+    } else if (advection_type != "MOL" && advection_type != "Godunov") {
+        amrex::Abort("HydroUtils::CalibrateBoxCost: unknown advection_type: "+advection_type);
+    }
+
+    // Large enough to keep the kernels busy, small enough to run in a blink
+#if (AMREX_SPACEDIM == 2)
+    const Box bx(IntVect(0), IntVect(31));
+#else
+    const Box bx(IntVect(0), IntVect(15));
+#endif
+    constexpr int ng = 5;
+    const Box gbx = amrex::grow(bx,ng);
+
+    // Keep the domain boundaries away from the stencils so every kernel takes
+    // its interior path
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    const Geometry geom(amrex::grow(bx,2*ng), rb, CoordSys::cartesian, is_periodic);
+    const Real dt = 0.1*geom.CellSize(0);
+
+    Vector<BCRec> h_bcrec(ncomp);
+    for (auto& bc : h_bcrec) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            bc.setLo(d, BCType::int_dir);
+            bc.setHi(d, BCType::int_dir);
+        }
+    }
+    Gpu::DeviceVector<BCRec> d_bcrec(ncomp);
+    Gpu::copyAsync(Gpu::hostToDevice, h_bcrec.begin(), h_bcrec.end(), d_bcrec.begin());
+    Gpu::DeviceVector<int> iconserv(ncomp, 1);
+    Gpu::streamSynchronize();
+
+    FArrayBox qfab(gbx, ncomp);
+    Array4<Real> const& qarr = qfab.array();
+    const auto dx = geom.CellSizeArray();
+    amrex::ParallelFor(gbx, ncomp, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+    {
+        amrex::ignore_unused(j,k);
+        AMREX_D_TERM(Real x = (i+0.5)*dx[0];,
+                     Real y = (j+0.5)*dx[1];,
+                     Real z = (k+0.5)*dx[2];);
+        qarr(i,j,k,n) = (n+1) * std::sin(AMREX_D_TERM(Real(6.)*x, + Real(4.)*y, + Real(2.)*z));
+    });
+    Array4<Real const> const& q = qfab.const_array();
+
+    FArrayBox fqfab(gbx, ncomp);
+    fqfab.setVal<RunOn::Device>(0.0);
+    FArrayBox divufab(gbx, 1);
+    divufab.setVal<RunOn::Device>(0.0);
+
+    Array<FArrayBox,AMREX_SPACEDIM> macfab;
+    Array<FArrayBox,AMREX_SPACEDIM> edgefab;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d)
+    {
+        macfab[d].resize(amrex::surroundingNodes(gbx,d), 1);
+        macfab[d].setVal<RunOn::Device>(1.0);
+        edgefab[d].resize(amrex::surroundingNodes(bx,d), ncomp);
+    }
+    AMREX_D_TERM(Array4<Real const> const& umac = macfab[0].const_array();,
+                 Array4<Real const> const& vmac = macfab[1].const_array();,
+                 Array4<Real const> const& wmac = macfab[2].const_array(););
+    AMREX_D_TERM(Array4<Real> const& xedge = edgefab[0].array();,
+                 Array4<Real> const& yedge = edgefab[1].array();,
+                 Array4<Real> const& zedge = edgefab[2].array(););
+
+    // A plane through the middle of the box at an angle to the grid gives the
+    // mix of regular, covered and cut cells, with varying volume and area
+    // fractions, that a tile next to the boundary sees
+    GpuArray<Real,AMREX_SPACEDIM> normal{AMREX_D_DECL(Real(1.0),Real(0.7),Real(0.4))};
+    Real offset = 0.0;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        offset += normal[d] * Real(0.5)*(bx.smallEnd(d) + bx.bigEnd(d) + 1);
+    }
+    const PlaneEB eb(gbx, normal, offset, false);
+    Array4<EBCellFlag const> const& flag = eb.flagfab.const_array();
+    AMREX_D_TERM(Array4<Real const> const& apx = eb.area[0].const_array();,
+                 Array4<Real const> const& apy = eb.area[1].const_array();,
+                 Array4<Real const> const& apz = eb.area[2].const_array(););
+    AMREX_D_TERM(Array4<Real const> const& fcx = eb.fcent[0].const_array();,
+                 Array4<Real const> const& fcy = eb.fcent[1].const_array();,
+                 Array4<Real const> const& fcz = eb.fcent[2].const_array(););
+
+    Real t_regular;
+    Real t_eb;
+    if (advection_type == "MOL")
+    {
+        t_regular = TimeKernel([&] () {
+            MOL::ComputeEdgeState(bx, AMREX_D_DECL(xedge,yedge,zedge), q, ncomp,
+                                  AMREX_D_DECL(umac,vmac,wmac),
+                                  geom.Domain(), h_bcrec, d_bcrec.data(), false);
+        });
+        t_eb = TimeKernel([&] () {
+            EBMOL::ComputeEdgeState(bx, AMREX_D_DECL(xedge,yedge,zedge), q, ncomp,
+                                    AMREX_D_DECL(umac,vmac,wmac),
+                                    geom.Domain(), h_bcrec, d_bcrec.data(),
+                                    AMREX_D_DECL(fcx,fcy,fcz), eb.ccent.const_array(),
+                                    eb.vfrac.const_array(), flag, false);
+        });
+    }
+    else
+    {
+        t_regular = TimeKernel([&] () {
+            Godunov::ComputeEdgeState(bx, ncomp, q, AMREX_D_DECL(xedge,yedge,zedge),
+                                      AMREX_D_DECL(umac,vmac,wmac),
+                                      divufab.const_array(), fqfab.const_array(),
+                                      geom, dt, d_bcrec.data(), iconserv.data(),
+                                      false, false, false);
+        });
+        t_eb = TimeKernel([&] () {
+            FArrayBox tmpfab(amrex::grow(bx,4), (4*AMREX_SPACEDIM + 2)*ncomp, The_Async_Arena());
+            EBGodunov::ComputeEdgeState(bx, ncomp, q, AMREX_D_DECL(xedge,yedge,zedge),
+                                        AMREX_D_DECL(umac,vmac,wmac),
+                                        divufab.const_array(), fqfab.const_array(),
+                                        geom, dt, h_bcrec, d_bcrec.data(), iconserv.data(),
+                                        tmpfab.dataPtr(), flag,
+                                        AMREX_D_DECL(apx,apy,apz), eb.vfrac.const_array(),
+                                        AMREX_D_DECL(fcx,fcy,fcz), eb.ccent.const_array(),
+                                        false, Array4<Real const>{});
+        });
+    }
+
+    // Time redistribution on the box cut by the plane and on one where every
+    // cell is small. The time is modeled as a*ncells + b*nsmall over the whole
+    // box, since Apply works on all cells of a tile that is not regular.
+    Real t_redist_plane  = 0.0;
+    Real t_redist_plates = 0.0;
+    const Real nsmall_plane  = CountSmallCells(eb, bx);
+    const Real nsmall_plates = bx.d_numPts();
+#ifndef PELEC_USE_PLASMA
+    if (!redistribution_type.empty() && redistribution_type != "NoRedist")
+    {
+        FArrayBox dUdt_in(gbx, ncomp);
+        FArrayBox dUdt_out(bx, ncomp);
+        dUdt_in.setVal<RunOn::Device>(1.0);
+
+        auto time_redist = [&] (PlaneEB const& reb)
+        {
+            return TimeKernel([&] () {
+                FArrayBox scratch(gbx, ncomp, The_Async_Arena());
+                if (redistribution_type == "FluxRedist") {
+                    scratch.setVal<RunOn::Device>(1.0);
+                }
+                Redistribution::Apply(bx, ncomp, dUdt_out.array(), dUdt_in.array(), q,
+                                      scratch.array(), reb.flagfab.const_array(),
+                                      AMREX_D_DECL(reb.area[0].const_array(),
+                                                   reb.area[1].const_array(),
+                                                   reb.area[2].const_array()),
+                                      reb.vfrac.const_array(),
+                                      AMREX_D_DECL(reb.fcent[0].const_array(),
+                                                   reb.fcent[1].const_array(),
+                                                   reb.fcent[2].const_array()),
+                                      reb.ccent.const_array(),
+                                      d_bcrec.data(), geom, dt, redistribution_type);
+            });
+        };
+        t_redist_plane  = time_redist(eb);
+        t_redist_plates = time_redist(PlaneEB(gbx, normal, Real(0.85), true));
+    }
+#endif
+
+    // Sum over ranks so that everybody builds the same DistributionMapping. The
+    // model only uses ratios, so there is no need to divide by the rank count.
+    Array<Real,4> t{t_regular, t_eb, t_redist_plane, t_redist_plates};
+    ParallelDescriptor::ReduceRealSum(t.data(), static_cast<int>(t.size()));
+    const Real t_reg = amrex::max(t[0], std::numeric_limits<Real>::min());
+
+    // Fit the redistribution time, clipping at zero against timing noise
+    const Real ncells = bx.d_numPts();
+    Real b_small = 0.0;
+    if (nsmall_plates > nsmall_plane) {
+        b_small = amrex::max(Real(0.0), (t[3] - t[2]) / (nsmall_plates - nsmall_plane));
+    }
+    const Real a_cell = amrex::max(Real(0.0), (t[2] - b_small*nsmall_plane) / ncells);
+
+    // Per cell, relative to a cell of the regular kernel
+    BoxCostModel model;
+    model.regular = 1.0;
+    model.eb      = t[1] / t_reg;
+    model.redist  = a_cell * ncells / t_reg;
+    model.small   = b_small * ncells / t_reg;
+
+    cache[key] = model;
+    return model;
+}
+
+Vector<Real>
+HydroUtils::EstimateBoxCost ( BoxArray const& ba,
+                              EBFArrayBoxFactory const& ebfact,
+                              std::string const& advection_type, int ncomp,
+                              std::string const& redistribution_type,
+                              BoxCostModel const* model )
+{
+    const BoxCostModel m = (model) ? *model
+                                   : CalibrateBoxCost(advection_type, ncomp, redistribution_type);
+
+    // Ghost cells around a tile whose cell types decide the kernel path: the
+    // edge state and flux kernels take the regular path if grow(tile,nghost_adv)
+    // is all regular (see ComputeFluxesOnBoxFromState) and ApplyMF copies a tile
+    // if grow(tile,nghost_redist) is (see Redistribution::ApplyMF)
+    const bool redistributes = !redistribution_type.empty() && redistribution_type != "NoRedist";
+    const int nghost_adv    = nGrowRequired(advection_type, false, "", GhostField::State);
+    const int nghost_redist = redistributes ? nGrowRedistributionRegular(redistribution_type) : 0;
+    const int ng = amrex::max(nghost_adv, nghost_redist);
+
+    // Flag the covered, the not regular and the small cut cells on the grids of the factory
+    const auto& flags = ebfact.getMultiEBCellFlagFab();
+    const auto& vfrac = ebfact.getVolFrac();
+
+    MultiFab cells(ebfact.boxArray(), ebfact.DistributionMap(), 3, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(cells,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& c = cells.array(mfi);
+        Array4<EBCellFlag const> const& flag = flags.const_array(mfi);
+        Array4<Real const> const& vf = vfrac.const_array(mfi);
+
+        amrex::ParallelFor(bx, [c,flag,vf] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            const bool is_cut = flag(i,j,k).isSingleValued() || flag(i,j,k).isMultiValued();
+            c(i,j,k,0) = flag(i,j,k).isCovered() ? 1.0 : 0.0;
+            c(i,j,k,1) = flag(i,j,k).isRegular() ? 0.0 : 1.0;
+            c(i,j,k,2) = (is_cut && vf(i,j,k) < 0.5) ? 1.0 : 0.0;
+        });
+    }
+
+    // Move the flags onto ba, with the ghost cells the tiles look at
+    const DistributionMapping dm = (ba == ebfact.boxArray()) ? ebfact.DistributionMap()
+                                                            : DistributionMapping(ba);
+    MultiFab cells_on_ba(ba, dm, 3, ng);
+    cells_on_ba.setVal(0.0);
+    cells_on_ba.ParallelCopy(cells, 0, 0, 3, IntVect(0), IntVect(ng));
+
+    // Add up the tiles of each box, with the tiling of the level drivers
+    Vector<Real> cost(ba.size(), 0.0);
+    for (MFIter mfi(cells_on_ba,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        FArrayBox const& fab = cells_on_ba[mfi];
+        const Real ncells = bx.d_numPts();
+
+        // The kernels skip fully covered tiles
+        if (fab.sum<RunOn::Device>(bx, 0, 1) == ncells) {
+            continue;
+        }
+
+        const bool eb_path = fab.max<RunOn::Device>(amrex::grow(bx,nghost_adv), 1) > 0.0;
+        Real c = ncells * (eb_path ? m.eb : m.regular);
+
+        if (redistributes && fab.max<RunOn::Device>(amrex::grow(bx,nghost_redist), 1) > 0.0) {
+            c += ncells * m.redist + m.small * fab.sum<RunOn::Device>(bx, 2, 1);
+        }
+
+        cost[mfi.index()] += ncomp * c;
+    }
+
+    // Each box lives on exactly one rank, so summing gathers the result everywhere
+    ParallelDescriptor::ReduceRealSum(cost.data(), static_cast<int>(cost.size()));
+
+    return cost;
+}
+#endif
+/** @}*/
@@ -11,8 +11,63 @@
 #include <hydro_ebmol.H>
 #endif
 
+#include <memory>
+
 using namespace amrex;
 
+namespace {
+    // Limit this function to this file
+    void
+    ExtrapVelToFacesOnRegion ( MultiFab const& vel,
+                               MultiFab const& vel_forces,
+                               AMREX_D_DECL(MultiFab& u_mac,
+                                            MultiFab& v_mac,
+                                            MultiFab& w_mac),
+                               Vector<BCRec> const& h_bcrec,
+                               BCRec  const* d_bcrec,
+                               const Geometry& geom,
+                               Real dt,
+#ifdef AMREX_USE_EB
+                               const EBFArrayBoxFactory& ebfact,
+                               MultiFab const* velocity_on_eb_inflow,
+#endif
+                               bool godunov_ppm, bool godunov_use_forces_in_trans,
+                               std::string const& advection_type,
+                               HydroUtils::AdvectiveCFLReducer* reducer,
+                               HydroUtils::TileRegion region)
+    {
+        if (advection_type == "Godunov") {
+#ifdef AMREX_USE_EB
+            if (!ebfact.isAllRegular())
+                EBGodunov::ExtrapVelToFaces(vel, vel_forces,
+                                            AMREX_D_DECL(u_mac, v_mac, w_mac),
+                                            h_bcrec, d_bcrec, geom, dt,
+                                            velocity_on_eb_inflow,  // Note that PPM not supported for EB
+                                            reducer, region);
+            else
+#endif
+                Godunov::ExtrapVelToFaces(vel, vel_forces,
+                                          AMREX_D_DECL(u_mac, v_mac, w_mac),
+                                          h_bcrec, d_bcrec,
+                                          geom, dt, godunov_ppm, godunov_use_forces_in_trans,
+                                          reducer, region);
+
+        } else if (advection_type == "MOL") {
+
+#ifdef AMREX_USE_EB
+            if (!ebfact.isAllRegular())
+                EBMOL::ExtrapVelToFaces(vel, AMREX_D_DECL(u_mac, v_mac, w_mac), geom, h_bcrec, d_bcrec,
+                                        reducer, region);
+            else
+#endif
+                MOL::ExtrapVelToFaces(vel, AMREX_D_DECL(u_mac, v_mac, w_mac), geom, h_bcrec, d_bcrec,
+                                      reducer, region);
+        } else {
+            amrex::Abort("Dont know this advection_type in HydroUtils::ExtrapVelToFaces");
+        }
+    }
+}
+
 #ifdef AMREX_USE_EB
 void
 HydroUtils::ExtrapVelToFaces ( amrex::MultiFab const& vel,
@@ -26,13 +81,14 @@ HydroUtils::ExtrapVelToFaces ( amrex::MultiFab const& vel,
                                amrex::Real dt,
                                const EBFArrayBoxFactory& ebfact,
                                bool godunov_ppm, bool godunov_use_forces_in_trans,
-                               std::string advection_type)
+                               std::string advection_type,
+                               AdvectiveCFL* cfl)
 {
    ExtrapVelToFaces(vel, vel_forces, AMREX_D_DECL(u_mac,v_mac,w_mac),
                     h_bcrec, d_bcrec, geom, dt,
                     ebfact, /*velocity_on_eb_inflow*/ nullptr,
                     godunov_ppm, godunov_use_forces_in_trans,
-                    advection_type);
+                    advection_type, cfl);
 }
 #endif
 
@@ -51,32 +107,112 @@ HydroUtils::ExtrapVelToFaces ( amrex::MultiFab const& vel,
                                amrex::MultiFab const* velocity_on_eb_inflow,
 #endif
                                bool godunov_ppm, bool godunov_use_forces_in_trans,
-                               std::string advection_type)
+                               std::string advection_type,
+                               AdvectiveCFL* cfl)
 {
-    if (advection_type == "Godunov") {
+    BL_PROFILE("HydroUtils::ExtrapVelToFaces");
+
+    // Constructed out here so that the drivers can add to it from their
+    // OpenMP parallel regions
+    std::unique_ptr<AdvectiveCFLReducer> reducer;
+    if (cfl) {
+        reducer = std::make_unique<AdvectiveCFLReducer>(geom);
+    }
+
+    ExtrapVelToFacesOnRegion(vel, vel_forces, AMREX_D_DECL(u_mac, v_mac, w_mac),
+                             h_bcrec, d_bcrec, geom, dt,
 #ifdef AMREX_USE_EB
-        if (!ebfact.isAllRegular())
-            EBGodunov::ExtrapVelToFaces(vel, vel_forces,
-                                        AMREX_D_DECL(u_mac, v_mac, w_mac),
-                                        h_bcrec, d_bcrec, geom, dt,
-                                        velocity_on_eb_inflow);  // Note that PPM not supported for EB
-        else
+                             ebfact, velocity_on_eb_inflow,
 #endif
-            Godunov::ExtrapVelToFaces(vel, vel_forces,
-                                      AMREX_D_DECL(u_mac, v_mac, w_mac),
-                                      h_bcrec, d_bcrec,
-                                      geom, dt, godunov_ppm, godunov_use_forces_in_trans);
+                             godunov_ppm, godunov_use_forces_in_trans,
+                             advection_type, reducer.get(), TileRegion::All);
 
-    } else if (advection_type == "MOL") {
+    if (cfl) {
+        *cfl = reducer->value();
+    }
+}
 
+void
+HydroUtils::FillBoundaryAndExtrapVelToFaces ( amrex::MultiFab& vel,
+                                              amrex::MultiFab& vel_forces,
+                                              AMREX_D_DECL(amrex::MultiFab& u_mac,
+                                                           amrex::MultiFab& v_mac,
+                                                           amrex::MultiFab& w_mac),
+                                              amrex::Vector<amrex::BCRec> const& h_bcrec,
+                                              amrex::BCRec  const* d_bcrec,
+                                              const amrex::Geometry& geom,
+                                              amrex::Real dt,
+#ifdef AMREX_USE_EB
+                                              const EBFArrayBoxFactory& ebfact,
+                                              amrex::MultiFab const* velocity_on_eb_inflow,
+#endif
+                                              bool godunov_ppm, bool godunov_use_forces_in_trans,
+                                              std::string advection_type,
+                                              AdvectiveCFL* cfl,
+                                              PhysBCFill const& fill_physbc)
+{
+    BL_PROFILE("HydroUtils::FillBoundaryAndExtrapVelToFaces");
+
+    std::unique_ptr<AdvectiveCFLReducer> reducer;
+    if (cfl) {
+        reducer = std::make_unique<AdvectiveCFLReducer>(geom);
+    }
+
+#ifdef AMREX_USE_EB
+    const bool is_eb = !ebfact.isAllRegular();
+#else
+    const bool is_eb = false;
+#endif
+
+    // Only exchange the ghost cells that are actually read. MOL does not use the forces.
+    const int nghost_vel = amrex::min(vel.nGrow(),
+                                      nGrowRequired(advection_type, is_eb, "", GhostField::State));
+    const int nghost_forces = amrex::min(vel_forces.nGrow(),
+                                         nGrowRequired(advection_type, is_eb, "", GhostField::Forcing));
+    const bool fill_vel    = nghost_vel > 0;
+    const bool fill_forces = nghost_forces > 0;
+
+    if (fill_vel) {
+        vel.FillBoundary_nowait(0, vel.nComp(), IntVect(nghost_vel), geom.periodicity());
+    }
+    if (fill_forces) {
+        vel_forces.FillBoundary_nowait(0, vel_forces.nComp(), IntVect(nghost_forces), geom.periodicity());
+    }
+
+    // On GPUs the tile is the whole box and the Halo region would be up to
+    // 2*AMREX_SPACEDIM thin slabs, each a separate launch, so do not overlap there
+    const Vector<TileRegion> regions = Gpu::inLaunchRegion()
+        ? Vector<TileRegion>{TileRegion::All}
+        : Vector<TileRegion>{TileRegion::Interior, TileRegion::Halo};
+
+    for (auto region : regions)
+    {
+        if (region != TileRegion::Interior) {
+            // Time left waiting for the exchange, plus the physical boundaries
+            BL_PROFILE_VAR("HydroUtils::FillBoundaryAndExtrapVelToFaces::finish", fb_finish);
+            if (fill_vel) {
+                vel.FillBoundary_finish();
+            }
+            if (fill_forces) {
+                vel_forces.FillBoundary_finish();
+            }
+            if (fill_physbc) {
+                fill_physbc();
+            }
+            BL_PROFILE_VAR_STOP(fb_finish);
+        }
+
+        ExtrapVelToFacesOnRegion(vel, vel_forces, AMREX_D_DECL(u_mac, v_mac, w_mac),
+                                 h_bcrec, d_bcrec, geom, dt,
 #ifdef AMREX_USE_EB
-        if (!ebfact.isAllRegular())
-            EBMOL::ExtrapVelToFaces(vel, AMREX_D_DECL(u_mac, v_mac, w_mac), geom, h_bcrec, d_bcrec);
-        else
+                                 ebfact, velocity_on_eb_inflow,
 #endif
-            MOL::ExtrapVelToFaces(vel, AMREX_D_DECL(u_mac, v_mac, w_mac), geom, h_bcrec, d_bcrec);
-    } else {
-        amrex::Abort("Dont know this advection_type in HydroUtils::ExtrapVelToFaces");
+                                 godunov_ppm, godunov_use_forces_in_trans,
+                                 advection_type, reducer.get(), region);
+    }
+
+    if (cfl) {
+        *cfl = reducer->value();
     }
 }
 /** @}*/
@@ -0,0 +1,463 @@
+/** \addtogroup Utilities
+ * @{
+ */
+
+#include <hydro_kernel_capture.H>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <utility>
+
+using namespace amrex;
+
+namespace {
+
+    constexpr char capture_magic[8] = {'H','Y','D','R','O','C','A','P'};
+    constexpr int capture_version = 1;
+
+    // Limit these functions to this file
+    template <typename T>
+    void
+    WriteRaw (std::ostream& os, T const* p, std::size_t n)
+    {
+        os.write(reinterpret_cast<char const*>(p), static_cast<std::streamsize>(n*sizeof(T)));
+    }
+
+    template <typename T>
+    void
+    ReadRaw (std::istream& is, T* p, std::size_t n)
+    {
+        is.read(reinterpret_cast<char*>(p), static_cast<std::streamsize>(n*sizeof(T)));
+    }
+
+    void
+    WriteInt (std::ostream& os, int v)
+    {
+        WriteRaw(os, &v, 1);
+    }
+
+    int
+    ReadInt (std::istream& is)
+    {
+        int v = 0;
+        ReadRaw(is, &v, 1);
+        return v;
+    }
+
+    void
+    WriteString (std::ostream& os, std::string const& s)
+    {
+        WriteInt(os, static_cast<int>(s.size()));
+        WriteRaw(os, s.data(), s.size());
+    }
+
+    std::string
+    ReadString (std::istream& is)
+    {
+        std::string s(ReadInt(is), '\0');
+        ReadRaw(is, &s[0], s.size());
+        return s;
+    }
+
+    void
+    WriteBox (std::ostream& os, Box const& b)
+    {
+        WriteRaw(os, b.smallEnd().begin(), AMREX_SPACEDIM);
+        WriteRaw(os, b.bigEnd().begin(), AMREX_SPACEDIM);
+        WriteRaw(os, b.type().begin(), AMREX_SPACEDIM);
+    }
+
+    Box
+    ReadBox (std::istream& is)
+    {
+        IntVect lo, hi, typ;
+        ReadRaw(is, lo.begin(), AMREX_SPACEDIM);
+        ReadRaw(is, hi.begin(), AMREX_SPACEDIM);
+        ReadRaw(is, typ.begin(), AMREX_SPACEDIM);
+        return Box(lo, hi, typ);
+    }
+
+    template <typename T>
+    void
+    WriteVector (std::ostream& os, Vector<T> const& v)
+    {
+        WriteInt(os, static_cast<int>(v.size()));
+        WriteRaw(os, v.data(), v.size());
+    }
+
+    template <typename T>
+    Vector<T>
+    ReadVector (std::istream& is)
+    {
+        Vector<T> v(ReadInt(is));
+        ReadRaw(is, v.data(), v.size());
+        return v;
+    }
+
+    template <typename M>
+    typename M::mapped_type const&
+    Find (M const& m, std::string const& name, std::string const& kernel)
+    {
+        auto it = m.find(name);
+        if (it == m.end()) {
+            amrex::Abort("HydroUtils::KernelArchive: no entry "+name+" in capture of "+kernel);
+        }
+        return it->second;
+    }
+
+    struct CaptureParams
+    {
+        int box = -1;
+        std::string file = "hydro_capture";
+        std::set<std::string> done;
+    };
+
+    CaptureParams&
+    GetCaptureParams ()
+    {
+        static CaptureParams params = [] () {
+            CaptureParams p;
+            ParmParse pp("hydro");
+            pp.query("capture_box", p.box);
+            pp.query("capture_file", p.file);
+            return p;
+        }();
+        return params;
+    }
+}
+
+HydroUtils::KernelArchive::KernelArchive (std::string kernel)
+    : m_kernel(std::move(kernel))
+{}
+
+void
+HydroUtils::KernelArchive::addInt (std::string const& name, int v)
+{
+    m_ints[name] = Vector<int>{v};
+}
+
+void
+HydroUtils::KernelArchive::addReal (std::string const& name, Real v)
+{
+    m_reals[name] = Vector<Real>{v};
+}
+
+void
+HydroUtils::KernelArchive::addString (std::string const& name, std::string const& v)
+{
+    m_strings[name] = v;
+}
+
+void
+HydroUtils::KernelArchive::addBox (std::string const& name, Box const& v)
+{
+    Vector<int>& b = m_ints[name];
+    b.clear();
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { b.push_back(v.smallEnd(d)); }
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { b.push_back(v.bigEnd(d)); }
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { b.push_back(v.type(d)); }
+}
+
+void
+HydroUtils::KernelArchive::addGeometry (std::string const& name, Geometry const& v)
+{
+    addBox(name+".domain", v.Domain());
+    Vector<int>& ints = m_ints[name+".coord"];
+    ints.clear();
+    ints.push_back(static_cast<int>(v.Coord()));
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { ints.push_back(v.isPeriodic(d)); }
+
+    Vector<Real>& reals = m_reals[name+".probdomain"];
+    reals.clear();
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { reals.push_back(v.ProbLo(d)); }
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) { reals.push_back(v.ProbHi(d)); }
+}
+
+void
+HydroUtils::KernelArchive::addInts (std::string const& name, int const* p, int n)
+{
+    Vector<int>& v = m_ints[name];
+    v.resize(n);
+    Gpu::dtoh_memcpy(v.data(), p, n*sizeof(int));
+}
+
+void
+HydroUtils::KernelArchive::addBCRecs (std::string const& name, BCRec const* p, int n)
+{
+    Vector<BCRec> bcs(n);
+    Gpu::dtoh_memcpy(bcs.data(), p, n*sizeof(BCRec));
+
+    Vector<int>& v = m_ints[name];
+    v.clear();
+    for (auto const& bc : bcs) {
+        for (int i = 0; i < 2*AMREX_SPACEDIM; ++i) {
+            v.push_back(bc.vect()[i]);
+        }
+    }
+}
+
+void
+HydroUtils::KernelArchive::addArray (std::string const& name, Array4<Real const> const& a)
+{
+    if (!a) { return; }
+
+    HostArray<Real>& h = m_arrays[name];
+    h.box   = Box(a);
+    h.ncomp = a.nComp();
+    h.data.resize(a.size());
+    Gpu::dtoh_memcpy(h.data.data(), a.dataPtr(), a.size()*sizeof(Real));
+}
+
+#ifdef AMREX_USE_EB
+void
+HydroUtils::KernelArchive::addFlags (std::string const& name, Array4<EBCellFlag const> const& a)
+{
+    static_assert(sizeof(EBCellFlag) == sizeof(std::uint32_t),
+                  "EBCellFlag is expected to hold a single 32-bit word");
+
+    if (!a) { return; }
+
+    HostArray<std::uint32_t>& h = m_flags[name];
+    h.box   = Box(a);
+    h.ncomp = a.nComp();
+    h.data.resize(a.size());
+    Gpu::dtoh_memcpy(h.data.data(), a.dataPtr(), a.size()*sizeof(std::uint32_t));
+}
+#endif
+
+int
+HydroUtils::KernelArchive::getInt (std::string const& name) const
+{
+    return Find(m_ints, name, m_kernel)[0];
+}
+
+Real
+HydroUtils::KernelArchive::getReal (std::string const& name) const
+{
+    return Find(m_reals, name, m_kernel)[0];
+}
+
+std::string const&
+HydroUtils::KernelArchive::getString (std::string const& name) const
+{
+    return Find(m_strings, name, m_kernel);
+}
+
+Box
+HydroUtils::KernelArchive::getBox (std::string const& name) const
+{
+    Vector<int> const& b = Find(m_ints, name, m_kernel);
+    IntVect lo, hi, typ;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        lo[d]  = b[d];
+        hi[d]  = b[d+AMREX_SPACEDIM];
+        typ[d] = b[d+2*AMREX_SPACEDIM];
+    }
+    return Box(lo, hi, typ);
+}
+
+Geometry
+HydroUtils::KernelArchive::getGeometry (std::string const& name) const
+{
+    const Box domain = getBox(name+".domain");
+    Vector<int> const& ints = Find(m_ints, name+".coord", m_kernel);
+    Vector<Real> const& reals = Find(m_reals, name+".probdomain", m_kernel);
+
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(ints[1],ints[2],ints[3])};
+    const RealBox rb(reals.data(), reals.data()+AMREX_SPACEDIM);
+    return Geometry(domain, rb, ints[0], is_periodic);
+}
+
+Gpu::DeviceVector<int>
+HydroUtils::KernelArchive::getInts (std::string const& name) const
+{
+    Vector<int> const& v = Find(m_ints, name, m_kernel);
+    Gpu::DeviceVector<int> d(v.size());
+    Gpu::copy(Gpu::hostToDevice, v.begin(), v.end(), d.begin());
+    return d;
+}
+
+Vector<BCRec>
+HydroUtils::KernelArchive::getBCRecs (std::string const& name) const
+{
+    Vector<int> const& v = Find(m_ints, name, m_kernel);
+    const int n = static_cast<int>(v.size()) / (2*AMREX_SPACEDIM);
+    Vector<BCRec> bcs;
+    for (int i = 0; i < n; ++i) {
+        int const* p = v.data() + 2*AMREX_SPACEDIM*i;
+        bcs.emplace_back(p, p+AMREX_SPACEDIM);
+    }
+    return bcs;
+}
+
+bool
+HydroUtils::KernelArchive::hasArray (std::string const& name) const
+{
+    return m_arrays.count(name) > 0;
+}
+
+void
+HydroUtils::KernelArchive::getArray (std::string const& name, FArrayBox& fab) const
+{
+    HostArray<Real> const& h = Find(m_arrays, name, m_kernel);
+    fab.resize(h.box, h.ncomp);
+    Gpu::htod_memcpy(fab.dataPtr(), h.data.data(), h.data.size()*sizeof(Real));
+}
+
+#ifdef AMREX_USE_EB
+void
+HydroUtils::KernelArchive::getFlags (std::string const& name, BaseFab<EBCellFlag>& fab) const
+{
+    HostArray<std::uint32_t> const& h = Find(m_flags, name, m_kernel);
+    fab.resize(h.box, h.ncomp);
+    Gpu::htod_memcpy(fab.dataPtr(), h.data.data(), h.data.size()*sizeof(std::uint32_t));
+}
+#endif
+
+void
+HydroUtils::KernelArchive::write (std::string const& filename) const
+{
+    std::ofstream os(filename, std::ios::binary);
+    if (!os.good()) {
+        amrex::FileOpenFailed(filename);
+    }
+
+    WriteRaw(os, capture_magic, sizeof(capture_magic));
+    WriteInt(os, capture_version);
+    WriteInt(os, AMREX_SPACEDIM);
+    WriteInt(os, static_cast<int>(sizeof(Real)));
+    WriteString(os, m_kernel);
+
+    WriteInt(os, static_cast<int>(m_ints.size()));
+    for (auto const& kv : m_ints) {
+        WriteString(os, kv.first);
+        WriteVector(os, kv.second);
+    }
+
+    WriteInt(os, static_cast<int>(m_reals.size()));
+    for (auto const& kv : m_reals) {
+        WriteString(os, kv.first);
+        WriteVector(os, kv.second);
+    }
+
+    WriteInt(os, static_cast<int>(m_strings.size()));
+    for (auto const& kv : m_strings) {
+        WriteString(os, kv.first);
+        WriteString(os, kv.second);
+    }
+
+    WriteInt(os, static_cast<int>(m_arrays.size()));
+    for (auto const& kv : m_arrays) {
+        WriteString(os, kv.first);
+        WriteBox(os, kv.second.box);
+        WriteInt(os, kv.second.ncomp);
+        WriteVector(os, kv.second.data);
+    }
+
+    WriteInt(os, static_cast<int>(m_flags.size()));
+    for (auto const& kv : m_flags) {
+        WriteString(os, kv.first);
+        WriteBox(os, kv.second.box);
+        WriteInt(os, kv.second.ncomp);
+        WriteVector(os, kv.second.data);
+    }
+
+    if (!os.good()) {
+        amrex::Abort("HydroUtils::KernelArchive::write: failed to write "+filename);
+    }
+}
+
+void
+HydroUtils::KernelArchive::read (std::string const& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is.good()) {
+        amrex::FileOpenFailed(filename);
+    }
+
+    char magic[sizeof(capture_magic)];
+    ReadRaw(is, magic, sizeof(magic));
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(std::equal(magic, magic+sizeof(magic), capture_magic),
+                                     "HydroUtils::KernelArchive::read: not a kernel capture file");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ReadInt(is) == capture_version,
+                                     "HydroUtils::KernelArchive::read: unsupported capture version");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ReadInt(is) == AMREX_SPACEDIM,
+                                     "HydroUtils::KernelArchive::read: capture was taken with a different AMREX_SPACEDIM");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ReadInt(is) == static_cast<int>(sizeof(Real)),
+                                     "HydroUtils::KernelArchive::read: capture was taken with a different precision");
+
+    *this = KernelArchive(ReadString(is));
+
+    for (int n = ReadInt(is); n > 0; --n) {
+        std::string name = ReadString(is);
+        m_ints[name] = ReadVector<int>(is);
+    }
+
+    for (int n = ReadInt(is); n > 0; --n) {
+        std::string name = ReadString(is);
+        m_reals[name] = ReadVector<Real>(is);
+    }
+
+    for (int n = ReadInt(is); n > 0; --n) {
+        std::string name = ReadString(is);
+        m_strings[name] = ReadString(is);
+    }
+
+    for (int n = ReadInt(is); n > 0; --n) {
+        HostArray<Real>& h = m_arrays[ReadString(is)];
+        h.box   = ReadBox(is);
+        h.ncomp = ReadInt(is);
+        h.data  = ReadVector<Real>(is);
+    }
+
+    for (int n = ReadInt(is); n > 0; --n) {
+        HostArray<std::uint32_t>& h = m_flags[ReadString(is)];
+        h.box   = ReadBox(is);
+        h.ncomp = ReadInt(is);
+        h.data  = ReadVector<std::uint32_t>(is);
+    }
+
+    if (is.fail()) {
+        amrex::Abort("HydroUtils::KernelArchive::read: "+filename+" is truncated");
+    }
+}
+
+bool
+HydroUtils::CaptureRequested (char const* kernel, int box)
+{
+    CaptureParams& params = GetCaptureParams();
+    if (box != params.box) {
+        return false;
+    }
+
+    bool first = false;
+#ifdef _OPENMP
+#pragma omp critical (hydro_kernel_capture)
+#endif
+    {
+        first = params.done.insert(kernel).second;
+    }
+    return first;
+}
+
+void
+HydroUtils::WriteCapture (KernelArchive const& archive, int box)
+{
+    std::string kernel = archive.kernel();
+    for (char& c : kernel) {
+        if (c == ':') { c = '_'; }
+    }
+
+    const std::string filename = GetCaptureParams().file + "_" + kernel + "_"
+                               + std::to_string(box) + ".bin";
+    archive.write(filename);
+
+    amrex::AllPrint() << "HydroUtils: captured " << archive.kernel() << " on box " << box
+                      << " to " << filename << '\n';
+}
+/** @}*/
@@ -8,8 +8,18 @@
 #include <AMReX_MultiCutFab.H>
 #endif
 
+#include <AMReX_OpenMP.H>
+
+#include <algorithm>
+#include <limits>
+
 using namespace amrex;
 
+namespace {
+    // Limit this variable to this file
+    HydroUtils::ThreadImbalance s_thread_imbalance;
+}
+
 
 void
 HydroUtils::ComputeFluxes ( Box const& bx,
@@ -483,4 +493,371 @@ HydroUtils::EB_ComputeFluxes ( Box const& bx,
 }
 
 #endif
+
+
+Box
+HydroUtils::SplitBoundarySlabs ( Box const& fbx, Box const& domain,
+                                 Array<bool,AMREX_SPACEDIM> const& bc_lo,
+                                 Array<bool,AMREX_SPACEDIM> const& bc_hi,
+                                 Vector<Box>& boundary )
+{
+    boundary.clear();
+
+    Box interior = fbx;
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+    {
+        // Faces normal to dir sit between cells i-1 and i
+        const int nodal = fbx.type(dir);
+        if (bc_lo[dir]) {
+            interior.setSmall(dir, amrex::max(interior.smallEnd(dir), domain.smallEnd(dir)+1+nodal));
+        }
+        if (bc_hi[dir]) {
+            interior.setBig(dir, amrex::min(interior.bigEnd(dir), domain.bigEnd(dir)-1));
+        }
+    }
+
+    if (interior.ok()) {
+        for (Box const& b : amrex::boxDiff(fbx, interior)) {
+            boundary.push_back(b);
+        }
+    } else {
+        boundary.push_back(fbx);
+    }
+
+    return interior;
+}
+
+int
+HydroUtils::nGrowRequired ( std::string const& advection_type, bool is_eb,
+                            std::string const& redistribution_type, GhostField field )
+{
+    // Cells read beyond a box of faces, see the drivers for where these come from:
+    //  MOL     : second order slopes of the two cells next to a face. With EB the
+    //            limited least squares slopes reach one cell further.
+    //  Godunov : predicted states are needed on the box grown by one for the
+    //            transverse terms, and PLM (4th order slopes) or PPM reach two
+    //            more cells. With EB the transverse terms need one more layer.
+    //  BDS     : same reach as Godunov.
+    int nstate = 0;
+    int nface  = 0;
+    if (advection_type == "MOL")
+    {
+        nstate = is_eb ? 3 : 2;
+        nface  = 0;
+    }
+    else if (advection_type == "Godunov")
+    {
+        nstate = is_eb ? 4 : 3;
+        nface  = is_eb ? 2 : 1;
+    }
+    else if (advection_type == "BDS")
+    {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!is_eb, "BDS is not available with EB");
+        nstate = 3;
+        nface  = 1;
+    }
+    else
+    {
+        amrex::Abort("HydroUtils::nGrowRequired: unknown advection_type: "+advection_type);
+    }
+
+    if (field != GhostField::State) {
+        // MOL reads neither the forcing nor divu, and the face velocities only
+        // on the faces of the box
+        return nface;
+    }
+
+    // StateRedist also reads U_in, i.e. the state, in ghost cells
+    if (is_eb && redistribution_type == "StateRedist") {
+        nstate = amrex::max(nstate, nGrowRedistribution(redistribution_type));
+    }
+    return nstate;
+}
+
+int
+HydroUtils::nGrowRedistribution ( std::string const& redistribution_type )
+{
+    if (redistribution_type == "NoRedist") {
+        return 0;
+    } else if (redistribution_type == "FluxRedist") {
+        return 2;
+    } else if (redistribution_type == "StateRedist") {
+        return 3;
+    } else {
+        amrex::Abort("HydroUtils::nGrowRedistribution: unknown redistribution_type: "+redistribution_type);
+        return 0;
+    }
+}
+
+int
+HydroUtils::nGrowRedistributionRegular ( std::string const& redistribution_type )
+{
+    if (redistribution_type == "NoRedist") {
+        return 0;
+    } else if (redistribution_type == "FluxRedist") {
+        return 2;
+    } else if (redistribution_type == "StateRedist") {
+        return 4;
+    } else {
+        amrex::Abort("HydroUtils::nGrowRedistributionRegular: unknown redistribution_type: "+redistribution_type);
+        return 0;
+    }
+}
+
+void
+HydroUtils::PoisonUnusedGhosts ( MultiFab& mf, int ngrow )
+{
+    if (ngrow >= mf.nGrow()) { return; }
+
+    const Real snan = std::numeric_limits<Real>::signaling_NaN();
+    const int ncomp = mf.nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const Box keep = amrex::grow(mfi.validbox(), ngrow);
+        Array4<Real> const& a = mf.array(mfi);
+        for (Box const& b : amrex::boxDiff(mfi.fabbox(), keep))
+        {
+            amrex::ParallelFor(b, ncomp, [a,snan]
+            AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+            {
+                a(i,j,k,n) = snan;
+            });
+        }
+    }
+}
+
+Vector<Box>
+HydroUtils::TileRegionBoxes ( MFIter const& mfi, TileRegion region, int nghost, bool split )
+{
+    const Box& bx = mfi.tilebox();
+    if (region == TileRegion::All) {
+        return {bx};
+    }
+
+    if (!split) {
+        return (region == TileRegion::Halo) ? Vector<Box>{bx} : Vector<Box>{};
+    }
+
+    const Box interior = bx & amrex::grow(mfi.validbox(), -nghost);
+
+    Vector<Box> boxes;
+    if (region == TileRegion::Interior) {
+        if (interior.ok()) {
+            boxes.push_back(interior);
+        }
+    } else {
+        if (interior.ok()) {
+            for (Box const& b : amrex::boxDiff(bx, interior)) {
+                boxes.push_back(b);
+            }
+        } else {
+            boxes.push_back(bx);
+        }
+    }
+    return boxes;
+}
+
+HydroUtils::ThreadImbalance const&
+HydroUtils::GetThreadImbalance ()
+{
+    return s_thread_imbalance;
+}
+
+void
+HydroUtils::ResetThreadImbalance ()
+{
+    s_thread_imbalance = ThreadImbalance{};
+}
+
+HydroUtils::TileScheduler::TileScheduler ( MultiFab const& mf, int nghost )
+    : m_busy(OpenMP::get_max_threads(), 0.0)
+{
+    amrex::ignore_unused(mf,nghost);
+#ifdef AMREX_USE_EB
+    // With a single thread, or a single tile per box on the GPU, the order the
+    // tiles are visited in does not matter
+    if (mf.hasEBFabFactory() && Gpu::notInLaunchRegion() && OpenMP::get_max_threads() > 1)
+    {
+        auto const& flags = dynamic_cast<EBFArrayBoxFactory const&>(mf.Factory()).getMultiEBCellFlagFab();
+
+        // Same tiling as info(), so the local tile indices match
+        m_pass.resize(MFIter(mf, TilingIfNotGPU()).length());
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const auto typ = flags[mfi].getType(amrex::grow(mfi.tilebox(), nghost));
+            m_pass[mfi.LocalTileIndex()] = (typ == FabType::singlevalued) ? 0 : 1;
+        }
+
+        const bool has_cut     = std::find(m_pass.begin(), m_pass.end(), 0) != m_pass.end();
+        const bool has_not_cut = std::find(m_pass.begin(), m_pass.end(), 1) != m_pass.end();
+        if (has_cut && has_not_cut) {
+            m_npasses = 2;
+        } else {
+            m_pass.clear();
+        }
+    }
+#endif
+}
+
+HydroUtils::TileScheduler::~TileScheduler ()
+{
+    if (Gpu::notInLaunchRegion())
+    {
+        const int nthreads = static_cast<int>(m_busy.size());
+        double max_busy = 0.0;
+        double sum_busy = 0.0;
+        for (double t : m_busy) {
+            max_busy = amrex::max(max_busy, t);
+            sum_busy += t;
+        }
+        s_thread_imbalance.max_busy  += static_cast<Real>(max_busy);
+        s_thread_imbalance.mean_busy += static_cast<Real>(sum_busy/nthreads);
+        ++s_thread_imbalance.num_loops;
+    }
+}
+
+MFItInfo
+HydroUtils::TileScheduler::info () const
+{
+    MFItInfo mfi_info;
+    if (Gpu::notInLaunchRegion()) {
+        mfi_info.EnableTiling().SetDynamic(true);
+    }
+    return mfi_info;
+}
+
+HydroUtils::TileScheduler::BusyTimer::BusyTimer ( TileScheduler& sched )
+    : m_sched(sched),
+      m_t0(amrex::second())
+{}
+
+HydroUtils::TileScheduler::BusyTimer::~BusyTimer ()
+{
+    m_sched.m_busy[OpenMP::get_thread_num()] += amrex::second() - m_t0;
+}
+
+HydroUtils::AdvectiveCFLReducer::AdvectiveCFLReducer (Geometry const& geom)
+    : m_reduce_data(m_reduce_op),
+      m_dxinv(geom.InvCellSizeArray())
+{}
+
+void
+HydroUtils::AdvectiveCFLReducer::add ( Box const& bx, Array4<Real const> const& vel,
+                                       AMREX_D_DECL(Box const& xbx,
+                                                    Box const& ybx,
+                                                    Box const& zbx),
+                                       AMREX_D_DECL(Array4<Real const> const& umac,
+                                                    Array4<Real const> const& vmac,
+                                                    Array4<Real const> const& wmac) )
+{
+    using ReduceTuple = typename decltype(m_reduce_data)::Type;
+    const auto dxinv = m_dxinv;
+
+    m_reduce_op.eval(bx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        Real r = 0.0;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            r = amrex::max(r, amrex::Math::abs(vel(i,j,k,d))*dxinv[d]);
+        }
+        return {r, Real(0.0)};
+    });
+
+    m_reduce_op.eval(xbx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        return {Real(0.0), amrex::Math::abs(umac(i,j,k))*dxinv[0]};
+    });
+
+    m_reduce_op.eval(ybx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        return {Real(0.0), amrex::Math::abs(vmac(i,j,k))*dxinv[1]};
+    });
+
+#if (AMREX_SPACEDIM == 3)
+    m_reduce_op.eval(zbx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        return {Real(0.0), amrex::Math::abs(wmac(i,j,k))*dxinv[2]};
+    });
+#endif
+}
+
+#ifdef AMREX_USE_EB
+void
+HydroUtils::AdvectiveCFLReducer::add ( Box const& bx, Array4<Real const> const& vel,
+                                       AMREX_D_DECL(Box const& xbx,
+                                                    Box const& ybx,
+                                                    Box const& zbx),
+                                       AMREX_D_DECL(Array4<Real const> const& umac,
+                                                    Array4<Real const> const& vmac,
+                                                    Array4<Real const> const& wmac),
+                                       Array4<EBCellFlag const> const& flag )
+{
+    using ReduceTuple = typename decltype(m_reduce_data)::Type;
+    const auto dxinv = m_dxinv;
+
+    m_reduce_op.eval(bx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        Real r = 0.0;
+        if (!flag(i,j,k).isCovered()) {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                r = amrex::max(r, amrex::Math::abs(vel(i,j,k,d))*dxinv[d]);
+            }
+        }
+        return {r, Real(0.0)};
+    });
+
+    // Covered faces may hold a placeholder value (see covered_val), so only
+    // look at faces connecting two uncovered cells
+    m_reduce_op.eval(xbx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        Real r = flag(i,j,k).isConnected(-1,0,0) ? amrex::Math::abs(umac(i,j,k))*dxinv[0]
+                                                 : Real(0.0);
+        return {Real(0.0), r};
+    });
+
+    m_reduce_op.eval(ybx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        Real r = flag(i,j,k).isConnected(0,-1,0) ? amrex::Math::abs(vmac(i,j,k))*dxinv[1]
+                                                 : Real(0.0);
+        return {Real(0.0), r};
+    });
+
+#if (AMREX_SPACEDIM == 3)
+    m_reduce_op.eval(zbx, m_reduce_data,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+    {
+        Real r = flag(i,j,k).isConnected(0,0,-1) ? amrex::Math::abs(wmac(i,j,k))*dxinv[2]
+                                                 : Real(0.0);
+        return {Real(0.0), r};
+    });
+#endif
+}
+#endif
+
+HydroUtils::AdvectiveCFL
+HydroUtils::AdvectiveCFLReducer::value ()
+{
+    auto const& hv = m_reduce_data.value(m_reduce_op);
+    Real r[2] = {amrex::get<0>(hv), amrex::get<1>(hv)};
+    ParallelDescriptor::ReduceRealMax(r, 2);
+
+    AdvectiveCFL cfl;
+    cfl.cell = r[0];
+    cfl.face = r[1];
+    return cfl;
+}
 /** @}*/